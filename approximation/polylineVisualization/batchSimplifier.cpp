@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <ostream>
+
+#include <glog/logging.h>
+
+#include <gcodeWriter.h>
+#include <simplification/polyline_3DouglasPeuckerRanking.h>
+#include <simplification/polyline_3Simplifier.h>
+#include <smoothing/polyline_3Smoother.h>
+
+#include "batchSimplifier.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(const Clock::time_point& start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // end anonymous namespace
+
+std::vector<CurveSimplificationResult> BatchSimplifier::run(
+    size_t firstIndex, size_t lastIndex) const {
+  if (lastIndex < firstIndex) return {};
+  const long numCurves = lastIndex - firstIndex + 1;
+  std::vector<std::vector<CurveSimplificationResult>> curveResults(numCurves);
+  // Curves vary widely in length, so hand them out dynamically.
+#pragma omp parallel for schedule(dynamic, 1)
+  for (long curve = 0; curve < numCurves; ++curve) {
+    curveResults[curve] = simplifyCurve(firstIndex + curve);
+  }
+
+  std::vector<CurveSimplificationResult> results;
+  for (std::vector<CurveSimplificationResult>& curve : curveResults) {
+    std::move(curve.begin(), curve.end(), std::back_inserter(results));
+  }
+  return results;
+}
+
+std::vector<CurveSimplificationResult> BatchSimplifier::simplifyCurve(
+    size_t index) const {
+  using Polyline_3 = Polyline<Kernel::Point_3>;
+  std::vector<float> tolerances = m_params.simplification_tolerances;
+  if (tolerances.empty()) {
+    tolerances.push_back(m_params.simplification_tolerance);
+  }
+  std::vector<CurveSimplificationResult> results(tolerances.size());
+  CurveSimplificationResult& first = results.front();
+  first.index = index;
+  std::string strIndex = std::to_string(index);
+
+  Clock::time_point stageStart = Clock::now();
+  Polyline_3 polyline;
+  first.loaded = buildPolylineFromVertexList(
+      m_params.file_basename + strIndex + m_params.file_ext, polyline);
+  first.loadSeconds = secondsSince(stageStart);
+  if (!first.loaded) {
+    results.resize(1);
+    return results;
+  }
+  first.numInputPoints = polyline.size();
+
+  stageStart = Clock::now();
+  Polyline_3Smoother smoother;
+  if (m_params.smoothing_strategy == "Implicit") {
+    polyline = smoother.smooth(
+        polyline,
+        Polyline_3SmoothingStrategyImplicit(m_params.smoothing_step_size,
+                                            m_params.smoothing_num_iterations));
+  } else if (m_params.smoothing_strategy == "CurvatureAdaptive") {
+    polyline = smoother.smooth(
+        polyline, Polyline_3SmoothingStrategyCurvatureAdaptive(
+                      m_params.smoothing_step_size,
+                      m_params.smoothing_num_iterations,
+                      m_params.smoothing_noise_threshold));
+  } else {
+    polyline = smoother.smooth(
+        polyline, Polyline_3SmoothingStrategyLaplacian(
+                      m_params.smoothing_step_size,
+                      m_params.smoothing_num_iterations));
+  }
+  first.smoothSeconds = secondsSince(stageStart);
+
+  // Douglas-Peucker thresholds a single ranking of the vertices at each
+  // tolerance, whose cost is charged to the first tolerance. The ranking is
+  // used even for a single tolerance, so that a curve simplifies to the same
+  // points at a tolerance whether or not other tolerances are asked for.
+  const bool circle = m_params.simplification_strategy == "Circle";
+  std::unique_ptr<Polyline_3DouglasPeuckerRanking> ranking;
+  if (!circle) {
+    stageStart = Clock::now();
+    ranking.reset(new Polyline_3DouglasPeuckerRanking(polyline));
+    first.simplifySeconds = secondsSince(stageStart);
+  }
+
+  for (size_t tolerance = 0; tolerance < tolerances.size(); ++tolerance) {
+    CurveSimplificationResult& result = results[tolerance];
+    result.index = index;
+    result.tolerance = tolerances[tolerance];
+    result.loaded = true;
+    result.numInputPoints = polyline.size();
+
+    stageStart = Clock::now();
+    if (circle) {
+      Polyline_3Simplifier simplifier(result.tolerance);
+      std::tuple<size_t, Biarc_3> arcs = simplifier.simplifyToArcs(
+          polyline, Polyline_3SimplificationStrategyNaiveBiarc());
+      result.numPrimitives = std::get<0>(arcs);
+      result.primitives = std::move(std::get<1>(arcs));
+      result.simplified = result.primitives.toPolyline(
+          result.tolerance * Polyline_3Simplifier::ARC_SAMPLING_TOLERANCE);
+    } else {
+      std::tuple<size_t, Polyline_3> simplifiedResult =
+          ranking->simplify(result.tolerance);
+      result.numPrimitives = std::get<0>(simplifiedResult);
+      result.simplified = std::move(std::get<1>(simplifiedResult));
+      for (auto point = result.simplified.begin();
+           point + 1 < result.simplified.end(); ++point) {
+        result.primitives.addPrimitive(
+            CurvePrimitive_3::line(*point, *(point + 1)));
+      }
+    }
+    result.simplifySeconds += secondsSince(stageStart);
+
+    if (m_params.error_sample_fraction > 0) {
+      stageStart = Clock::now();
+      result.deviation =
+          Polyline_3ErrorEvaluator(m_params.error_sample_fraction *
+                                   result.tolerance)
+              .evaluate(polyline, result.simplified);
+      result.evaluated = true;
+      result.evaluateSeconds = secondsSince(stageStart);
+    }
+
+    if (!m_params.output_dir.empty()) {
+      stageStart = Clock::now();
+      // With several tolerances, the files of each are told apart by the
+      // tolerance, spelled as in the DoE file names (0_005 for 0.005).
+      std::string outputBasePath = m_params.output_dir + "/simplified" +
+                                   strIndex;
+      if (tolerances.size() > 1) {
+        std::string tag = std::to_string(result.tolerance);
+        tag.erase(tag.find_last_not_of('0') + 1);
+        if (tag.back() == '.') tag.pop_back();
+        std::replace(tag.begin(), tag.end(), '.', '_');
+        outputBasePath += "_" + tag;
+      }
+      // Fitted arcs are written as G-code only, as the samples of the arcs
+      // may well outnumber the input points.
+      if (!circle) {
+        std::string outputFilePath = outputBasePath + m_params.file_ext;
+        std::ofstream ofile(outputFilePath);
+        LOG_IF(ERROR, !ofile.good()) << "Could not open " << outputFilePath
+                                     << " to write the simplified curve";
+        for (const auto& point : result.simplified) {
+          ofile << point << "\n";
+        }
+      }
+      if (circle || m_params.write_gcode) {
+        GCodeWriter().write(result.primitives, outputBasePath + ".nc");
+      }
+      result.writeSeconds = secondsSince(stageStart);
+    }
+  }
+  return results;
+}
+
+void BatchSimplifier::report(
+    const std::vector<CurveSimplificationResult>& results, double wallSeconds,
+    std::ostream& out) {
+  // Points before and after simplification, summed over the curves, by
+  // tolerance
+  std::map<float, std::pair<size_t, size_t>> totalPoints;
+  size_t numOverTolerance = 0;
+  double loadSeconds = 0, smoothSeconds = 0, simplifySeconds = 0,
+         writeSeconds = 0, evaluateSeconds = 0;
+  for (const CurveSimplificationResult& result : results) {
+    if (!result.loaded) {
+      out << "Curve " << result.index << ": could not be loaded\n";
+      continue;
+    }
+    out << "Curve " << result.index << " at tolerance " << result.tolerance
+        << ": simplification ratio "
+        << result.numPrimitives / (double)result.numInputPoints << " ("
+        << result.numPrimitives << "/" << result.numInputPoints << ")";
+    if (result.evaluated) {
+      out << ", Hausdorff " << result.deviation.hausdorff << ", mean "
+          << result.deviation.meanDeviation;
+      if (result.deviation.hausdorff > result.tolerance) {
+        out << " -- exceeds tolerance";
+        ++numOverTolerance;
+      }
+    }
+    out << "\n";
+    totalPoints[result.tolerance].first += result.numInputPoints;
+    totalPoints[result.tolerance].second += result.numPrimitives;
+    loadSeconds += result.loadSeconds;
+    smoothSeconds += result.smoothSeconds;
+    simplifySeconds += result.simplifySeconds;
+    writeSeconds += result.writeSeconds;
+    evaluateSeconds += result.evaluateSeconds;
+  }
+
+  out << std::fixed << std::setprecision(3)
+      << "Stage times summed over curves (s): load " << loadSeconds
+      << ", smooth " << smoothSeconds << ", simplify " << simplifySeconds
+      << ", write " << writeSeconds << ", evaluate " << evaluateSeconds
+      << "\n"
+      << "Wall time (s): " << wallSeconds << "\n";
+  out.unsetf(std::ios::floatfield);
+  if (numOverTolerance != 0) {
+    out << numOverTolerance << " curve(s) exceed their tolerance\n";
+  }
+  for (const auto& tolerancePoints : totalPoints) {
+    if (tolerancePoints.second.first == 0) continue;
+    out << "Net simplification ratio at tolerance " << tolerancePoints.first
+        << " "
+        << tolerancePoints.second.second /
+               (double)tolerancePoints.second.first
+        << "\n";
+  }
+  out << std::flush;
+}
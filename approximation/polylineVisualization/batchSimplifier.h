@@ -0,0 +1,97 @@
+#ifndef _POLYLINE_VISUALIZATION_BATCH_SIMPLIFIER_H_
+#define _POLYLINE_VISUALIZATION_BATCH_SIMPLIFIER_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "biarc_3.h"
+#include "geometryTypes.h"
+#include "polyline.h"
+#include "simplification/polyline_3ErrorEvaluator.h"
+
+struct BatchSimplificationParams {
+  std::string file_basename;
+  std::string file_ext;
+  // Directory where the simplified curves are written, one file per curve.
+  // Nothing is written if empty.
+  std::string output_dir;
+  // Whether to also write each simplified curve to output_dir as a G-code
+  // toolpath. Curves of the Circle strategy are always written as G-code,
+  // with the fitted arcs as G02/G03 moves, in place of a point list.
+  bool write_gcode = false;
+  std::string simplification_strategy;
+  // "Laplacian" for explicit iterations, "Implicit" for a backward Euler
+  // solve of the same strength, see Polyline_3SmoothingStrategyImplicit, or
+  // "CurvatureAdaptive" for the iterations on the noisy stretches only.
+  std::string smoothing_strategy = "Laplacian";
+  float smoothing_step_size;
+  size_t smoothing_num_iterations;
+  // Curvature noise (in inverse length units) beyond which the
+  // CurvatureAdaptive strategy smooths a stretch of a curve
+  float smoothing_noise_threshold = 10;
+  float simplification_tolerance;
+  // Tolerances to simplify each curve at, in a single run, with one output
+  // file per curve and tolerance. Curves are loaded and smoothed once, and
+  // Douglas-Peucker ranks the vertices once, to threshold them at each
+  // tolerance (see Polyline_3DouglasPeuckerRanking, also used for a single
+  // tolerance). simplification_tolerance alone is used if empty.
+  std::vector<float> simplification_tolerances;
+  // Spacing of the samples at which the deviation of the simplified curve
+  // from the smoothed one is measured, as a fraction of the tolerance, so that
+  // the measurement error (half the spacing) is well below every tolerance.
+  // Not measured if 0.
+  float error_sample_fraction = 0;
+};
+
+// Outcome, and per stage timings in seconds, of simplifying a single curve at
+// a single tolerance. Load and smooth times are those of the first tolerance
+// of a curve only, as the other tolerances reuse the smoothed curve.
+struct CurveSimplificationResult {
+  size_t index = 0;
+  float tolerance = 0;
+  bool loaded = false;
+  size_t numInputPoints = 0;
+  size_t numPrimitives = 0;
+  Polyline<Kernel::Point_3> simplified;
+  // The simplified curve as lines and arcs
+  Biarc_3 primitives;
+  bool evaluated = false;
+  Polyline_3Deviation deviation;
+  double loadSeconds = 0;
+  double smoothSeconds = 0;
+  double simplifySeconds = 0;
+  double writeSeconds = 0;
+  double evaluateSeconds = 0;
+};
+
+// Loads, smooths, simplifies and writes out a range of curves. Curves are
+// independent of one another, and are processed in parallel, on as many
+// threads as OpenMP provides (see OMP_NUM_THREADS). Results are gathered by
+// curve index, and thus, are reported in a deterministic order regardless of
+// the order in which the curves finish.
+class BatchSimplifier {
+ public:
+  explicit BatchSimplifier(const BatchSimplificationParams& params)
+      : m_params(params) {}
+
+  // Processes the curves with indexes in [firstIndex, lastIndex]. The results
+  // are in order of the curve indexes, and for each curve, in order of the
+  // tolerances.
+  std::vector<CurveSimplificationResult> run(size_t firstIndex,
+                                             size_t lastIndex) const;
+
+  // Prints the per curve simplification ratios and deviations, the time spent
+  // in each stage summed over the curves, and the aggregate simplification
+  // ratio of each tolerance. Curves whose deviation exceeds their tolerance
+  // are flagged.
+  static void report(const std::vector<CurveSimplificationResult>& results,
+                     double wallSeconds, std::ostream& out);
+
+ private:
+  std::vector<CurveSimplificationResult> simplifyCurve(size_t index) const;
+
+  BatchSimplificationParams m_params;
+};
+
+#endif  //_POLYLINE_VISUALIZATION_BATCH_SIMPLIFIER_H_
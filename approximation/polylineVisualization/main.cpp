@@ -1,3 +1,4 @@
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -17,13 +18,17 @@
 #include <selectionManager.h>
 
 #include <defaultRenderables.h>
+#include <gcodeWriter.h>
 #include <polyline.h>
 #include <polyloop_3.h>
 #include <prefabs.h>
 
+#include <simplification/polyline_3DouglasPeuckerRanking.h>
 #include <simplification/polyline_3Simplifier.h>
 #include <smoothing/polyline_3Smoother.h>
 
+#include "batchSimplifier.h"
+
 DEFINE_string(
     file_basename,
     "/home/mukul/development/experiments/approximation/data/simplification/"
@@ -39,12 +44,35 @@ DEFINE_string(
     "simplified/curves",
     "Name of the directory where simplified polyloops will be written");
 DEFINE_string(simplification_strategy, "Circle",
-              "Name of the simplification strategy");
+              "Name of the simplification strategy: Circle (lines and arcs), "
+              "or any other for classic Douglas-Peucker, in all modes");
+DEFINE_string(smoothing_strategy, "Laplacian",
+              "Name of the smoothing strategy: Laplacian (explicit "
+              "iterations), Implicit (a single solve of the same strength) or "
+              "CurvatureAdaptive (iterations on the noisy stretches only)");
+DEFINE_double(smoothing_noise_threshold, 10,
+              "Curvature noise (1 / length) beyond which the CurvatureAdaptive "
+              "smoothing strategy smooths a stretch of a curve");
 DEFINE_double(smoothing_step_size, 0.05,
               "Stepsize taken per smoothing iteration");
 DEFINE_double(smoothing_num_iterations, 100, "Number of smoothing iterations");
 DEFINE_double(simplification_tolerance, 0.025, "Simplification tolerance");
+DEFINE_string(simplification_tolerances, "",
+              "In batch mode, comma separated tolerances (e.g. "
+              "0.0015,0.005,0.01,0.025) to simplify each curve at in a single "
+              "run, in place of simplification_tolerance");
+DEFINE_double(error_sample_fraction, 0.1,
+              "Spacing of the samples along the curves at which the batch "
+              "mode measures the simplification error, as a fraction of each "
+              "tolerance, or 0 to skip it");
+DEFINE_bool(write_gcode, false,
+            "Also write the simplified curves to output_dir as G-code "
+            "toolpaths. Always done for the fitted arcs of the Circle "
+            "strategy, in place of their point list");
 DEFINE_bool(with_gui, false, "Run with gui or not");
+DEFINE_bool(batch, false,
+            "Without gui, simplify the curves in parallel (on OMP_NUM_THREADS "
+            "threads), writing them to output_dir, and report timings");
 
 bool initScene(const std::string& windowName, const std::string& sceneName) {
   Ogre::Root* root = Ogre::Root::getSingletonPtr();
@@ -97,6 +125,57 @@ class RenderFrameCallbackHandler {
 
 void simplifyPolyloop(int index) {}
 
+Polyline<Kernel::Point_3> smoothPolyline(
+    const Polyline<Kernel::Point_3>& polyline) {
+  Polyline_3Smoother smoother;
+  if (FLAGS_smoothing_strategy == "Implicit") {
+    return smoother.smooth(
+        polyline,
+        Polyline_3SmoothingStrategyImplicit(FLAGS_smoothing_step_size,
+                                            FLAGS_smoothing_num_iterations));
+  }
+  if (FLAGS_smoothing_strategy == "CurvatureAdaptive") {
+    return smoother.smooth(polyline,
+                           Polyline_3SmoothingStrategyCurvatureAdaptive(
+                               FLAGS_smoothing_step_size,
+                               FLAGS_smoothing_num_iterations,
+                               FLAGS_smoothing_noise_threshold));
+  }
+  return smoother.smooth(
+      polyline, Polyline_3SmoothingStrategyLaplacian(
+                    FLAGS_smoothing_step_size, FLAGS_smoothing_num_iterations));
+}
+
+// Simplifies the polyline with the strategy of the flags, as lines and arcs,
+// one primitive each. Also returns a polyline of the primitives: the points
+// kept by Douglas-Peucker, or, for the Circle strategy, samples of the arcs,
+// which are for display only, as they may well outnumber the input points.
+std::tuple<size_t, Biarc_3, Polyline<Kernel::Point_3>> simplifyPolyline(
+    const Polyline<Kernel::Point_3>& polyline) {
+  Polyline_3Simplifier simplifier(FLAGS_simplification_tolerance);
+  if (FLAGS_simplification_strategy == "Circle") {
+    std::tuple<size_t, Biarc_3> arcs = simplifier.simplifyToArcs(
+        polyline, Polyline_3SimplificationStrategyNaiveBiarc());
+    Polyline<Kernel::Point_3> samples = std::get<1>(arcs).toPolyline(
+        FLAGS_simplification_tolerance *
+        Polyline_3Simplifier::ARC_SAMPLING_TOLERANCE);
+    return std::make_tuple(std::get<0>(arcs), std::move(std::get<1>(arcs)),
+                           std::move(samples));
+  }
+  // Classic Douglas-Peucker, as in batch mode, for the same curves at the
+  // same tolerance in all modes.
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplified =
+      Polyline_3DouglasPeuckerRanking(polyline).simplify(
+          FLAGS_simplification_tolerance);
+  Biarc_3 lines;
+  const Polyline<Kernel::Point_3>& points = std::get<1>(simplified);
+  for (auto point = points.begin(); point + 1 < points.end(); ++point) {
+    lines.addPrimitive(CurvePrimitive_3::line(*point, *(point + 1)));
+  }
+  return std::make_tuple(std::get<0>(simplified), std::move(lines),
+                         std::move(std::get<1>(simplified)));
+}
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   google::ParseCommandLineFlags(&argc, &argv, true);
@@ -137,22 +216,10 @@ int main(int argc, char* argv[]) {
           return -1;
         }
 
-        Polyline_3Smoother smoother;
-        polyline = smoother.smooth(
-            polyline,
-            Polyline_3SmoothingStrategyLaplacian(
-                FLAGS_smoothing_step_size, FLAGS_smoothing_num_iterations));
-
-        Polyline_3Simplifier simplifier(FLAGS_simplification_tolerance);
-        std::tuple<size_t, Polyline_3> simplifiedResult;
-        if (FLAGS_simplification_strategy == "Circle") {
-          simplifiedResult = simplifier.simplify(
-              polyline, Polyline_3SimplificationStrategyNaiveBiarc());
-        } else {
-          simplifiedResult = simplifier.simplify(
-              polyline, Polyline_3SimplificationStrategyDouglasPeucker());
-        }
-        auto simplifiedRep = std::get<1>(simplifiedResult);
+        polyline = smoothPolyline(polyline);
+
+        auto simplifiedResult = simplifyPolyline(polyline);
+        const Polyline_3& simplifiedRep = std::get<2>(simplifiedResult);
 
         make_mesh_renderable(polyline, "loop" + strIndex);
         Ogre::Entity* loopEntity =
@@ -171,17 +238,27 @@ int main(int argc, char* argv[]) {
                 "loopNodeSimplified" + strIndex);
         simplifiedLoopNode->attachObject(simplifiedLoopEntity);
 
-        // Also, write the simplified loops to file
+        // Also, write the simplified loops to file: the points kept, or the
+        // fitted arcs as G-code
+        const bool circle = FLAGS_simplification_strategy == "Circle";
+        std::string outputBasePath =
+            FLAGS_output_dir + "/simplified" + strIndex;
         std::string outputFilePath =
-            FLAGS_output_dir + "/simplified" + strIndex + FLAGS_file_ext;
+            circle ? outputBasePath + ".nc" : outputBasePath + FLAGS_file_ext;
         LOG(ERROR) << "Writing simplified file to " << outputFilePath
                    << " with simplification ratio "
                    << std::get<0>(simplifiedResult) / (float)polyline.size();
         totalPointsRefined += polyline.size();
         totalPointsSimplified += std::get<0>(simplifiedResult);
-        std::ofstream ofile(outputFilePath);
-        for (const auto& point : simplifiedRep) {
-          ofile << point << "\n";
+        if (!circle) {
+          std::ofstream ofile(outputFilePath);
+          for (const auto& point : simplifiedRep) {
+            ofile << point << "\n";
+          }
+        }
+        if (circle || FLAGS_write_gcode) {
+          GCodeWriter().write(std::get<1>(simplifiedResult),
+                              outputBasePath + ".nc");
         }
       }
       std::cout << "Net simplification ratio "
@@ -197,6 +274,39 @@ int main(int argc, char* argv[]) {
           &RenderFrameCallbackHandler::frameCallback, &callbackHandler);
       app.startEventLoop(&callBackFn);
     }
+  } else if (FLAGS_batch) {
+    BatchSimplificationParams params;
+    params.file_basename = FLAGS_file_basename;
+    params.file_ext = FLAGS_file_ext;
+    params.output_dir = FLAGS_output_dir;
+    params.write_gcode = FLAGS_write_gcode;
+    params.simplification_strategy = FLAGS_simplification_strategy;
+    params.smoothing_strategy = FLAGS_smoothing_strategy;
+    params.smoothing_step_size = FLAGS_smoothing_step_size;
+    params.smoothing_num_iterations = FLAGS_smoothing_num_iterations;
+    params.smoothing_noise_threshold = FLAGS_smoothing_noise_threshold;
+    params.simplification_tolerance = FLAGS_simplification_tolerance;
+    if (!FLAGS_simplification_tolerances.empty()) {
+      std::vector<std::string> tolerances;
+      boost::split(tolerances, FLAGS_simplification_tolerances,
+                   boost::is_any_of(","));
+      for (const std::string& tolerance : tolerances) {
+        params.simplification_tolerances.push_back(
+            boost::lexical_cast<float>(boost::trim_copy(tolerance)));
+      }
+    }
+    params.error_sample_fraction = FLAGS_error_sample_fraction;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CurveSimplificationResult> results =
+        BatchSimplifier(params).run(indexes[0], indexes[1]);
+    double wallSeconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    BatchSimplifier::report(results, wallSeconds, std::cout);
+    for (const auto& result : results) {
+      if (!result.loaded) return -1;
+    }
   } else {
     for (int index = indexes[0]; index <= indexes[1]; ++index) {
       std::string strIndex = std::to_string(index);
@@ -206,27 +316,21 @@ int main(int argc, char* argv[]) {
         return -1;
       }
 
-      Polyline_3Smoother smoother;
-      polyline = smoother.smooth(polyline, Polyline_3SmoothingStrategyLaplacian(
-                                               FLAGS_smoothing_step_size,
-                                               FLAGS_smoothing_num_iterations));
+      polyline = smoothPolyline(polyline);
 
-      Polyline_3Simplifier simplifier(FLAGS_simplification_tolerance);
-      std::tuple<size_t, Polyline_3> simplifiedResult;
-      if (FLAGS_simplification_strategy == "Circle") {
-        simplifiedResult = simplifier.simplify(
-            polyline, Polyline_3SimplificationStrategyNaiveBiarc());
-      } else {
-        simplifiedResult = simplifier.simplify(
-            polyline, Polyline_3SimplificationStrategyDouglasPeucker());
-      }
-      auto simplifiedRep = std::get<1>(simplifiedResult);
+      auto simplifiedResult = simplifyPolyline(polyline);
 
-      // Also, write the simplified loops to cout
+      // Also, write the simplified loops to cout: the points kept, or the
+      // fitted arcs as G-code
       std::cout << "Simplification ratio: "
-                << std::get<0>(simplifiedResult) / (float)polyline.size();
-      for (const auto& point : simplifiedRep) {
-        std::cout << point << "\n";
+                << std::get<0>(simplifiedResult) / (float)polyline.size()
+                << "\n";
+      if (FLAGS_simplification_strategy == "Circle") {
+        GCodeWriter().write(std::get<1>(simplifiedResult), std::cout);
+      } else {
+        for (const auto& point : std::get<2>(simplifiedResult)) {
+          std::cout << point << "\n";
+        }
       }
     }
   }
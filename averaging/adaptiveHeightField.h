@@ -0,0 +1,389 @@
+#ifndef _ADAPTIVE_HEIGHT_FIELD_H_
+#define _ADAPTIVE_HEIGHT_FIELD_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "geometryTypes.h"
+#include "indexedTriangleMesh.h"
+
+struct AdaptiveHeightFieldParams {
+  AdaptiveHeightFieldParams()
+      : min_depth(3),
+        max_depth(10),
+        pixel_tolerance(1),
+        variation_tolerance(1e-3) {}
+
+  // Every tile is refined to at least min_depth, and at most to max_depth.
+  // At max_depth, the tiles are as fine as a uniform grid of 2^max_depth
+  // samples along each side.
+  size_t min_depth;
+  size_t max_depth;
+  // With a camera, tiles are refined while their projected deviation from a
+  // bilinear patch exceeds this many pixels.
+  float pixel_tolerance;
+  // Without a camera, tiles are refined while their deviation from a bilinear
+  // patch exceeds this height.
+  float variation_tolerance;
+};
+
+// Builds an adaptively sampled, crack free height field mesh over a
+// rectangular domain with a restricted quadtree. Tiles are refined where the
+// field deviates from a bilinear interpolation of the tile corners, weighted
+// by the distance to the camera when one is set. The quadtree is then
+// balanced, so that neighbouring tiles differ by at most one level, and tiles
+// next to finer tiles are triangulated as fans that include the midpoints of
+// the shared edges. Samples are cached on the lattice of the finest level, so
+// that a location is sampled only once, and vertices are shared between
+// tiles.
+//
+// The output mesh has a vertex (x, y, height) for every used sample, where x
+// and y are the coordinates of the sample in the domain.
+class AdaptiveHeightField {
+ public:
+  // The domain spans corner + s * uExtent + t * vExtent, for s, t in [0, 1].
+  AdaptiveHeightField(const Kernel::Point_3& corner,
+                      const Kernel::Vector_3& uExtent,
+                      const Kernel::Vector_3& vExtent,
+                      const AdaptiveHeightFieldParams& params =
+                          AdaptiveHeightFieldParams())
+      : m_corner(corner),
+        m_uExtent(uExtent),
+        m_vExtent(vExtent),
+        m_params(params),
+        m_latticeSize(static_cast<std::uint64_t>(1) << params.max_depth),
+        m_hasCamera(false) {
+    CHECK(params.min_depth <= params.max_depth)
+        << "Adaptive height field min depth exceeds max depth";
+    CHECK(params.max_depth <= MAX_DEPTH)
+        << "Adaptive height field max depth is too large";
+  }
+
+  // pixelsPerRadian is the viewport size in pixels over its field of view.
+  void setCamera(const Kernel::Point_3& eye, float pixelsPerRadian) {
+    m_eye = eye;
+    m_pixelsPerRadian = pixelsPerRadian;
+    m_hasCamera = true;
+  }
+
+  void clearCamera() { m_hasCamera = false; }
+
+  template <typename Field>
+  void build(const Field& field, IndexedTriangleMesh& mesh) {
+    m_samples.clear();
+    m_leaves.clear();
+    m_minHeight = std::numeric_limits<float>::max();
+    m_maxHeight = std::numeric_limits<float>::lowest();
+
+    refine(field);
+    balance();
+    triangulate(field, mesh);
+
+    LOG(INFO) << "Built adaptive height field with " << m_leaves.size()
+              << " tiles, " << m_samples.size() << " samples and "
+              << mesh.numTriangles() << " triangles";
+  }
+
+  float minHeight() const { return m_minHeight; }
+  float maxHeight() const { return m_maxHeight; }
+  size_t numSamples() const { return m_samples.size(); }
+  size_t numTiles() const { return m_leaves.size(); }
+
+ private:
+  static constexpr size_t MAX_DEPTH = 24;
+
+  // Tiles are keyed by their level, and their index along u and v at that
+  // level. Lattice locations are keyed by their indices on the finest level.
+  using Key = std::uint64_t;
+  struct Tile {
+    size_t level;
+    std::uint64_t i;
+    std::uint64_t j;
+  };
+
+  static Key tileKey(size_t level, std::uint64_t i, std::uint64_t j) {
+    return (static_cast<Key>(level) << 58) | (i << 29) | j;
+  }
+  static Tile tileFromKey(Key key) {
+    const Key mask = (static_cast<Key>(1) << 29) - 1;
+    return Tile{static_cast<size_t>(key >> 58), (key >> 29) & mask,
+                key & mask};
+  }
+  Key latticeKey(std::uint64_t x, std::uint64_t y) const {
+    return x * (m_latticeSize + 1) + y;
+  }
+  std::uint64_t tileSpan(size_t level) const {
+    return m_latticeSize >> level;
+  }
+
+  Kernel::Point_3 latticeLocation(Key key) const {
+    std::uint64_t x = key / (m_latticeSize + 1);
+    std::uint64_t y = key % (m_latticeSize + 1);
+    return m_corner + (Kernel::FT(x) / m_latticeSize) * m_uExtent +
+           (Kernel::FT(y) / m_latticeSize) * m_vExtent;
+  }
+
+  // The 3x3 lattice locations of a tile -- corners, edge midpoints and
+  // center -- indexed by [u][v] in halves of the tile span. Tiles at the
+  // finest level only have valid corners.
+  using TileSamples = std::array<std::array<Key, 3>, 3>;
+  TileSamples tileSamples(const Tile& tile) const {
+    std::uint64_t span = tileSpan(tile.level);
+    std::uint64_t x = tile.i * span;
+    std::uint64_t y = tile.j * span;
+    TileSamples keys;
+    for (int u = 0; u < 3; ++u) {
+      for (int v = 0; v < 3; ++v) {
+        keys[u][v] = latticeKey(x + u * span / 2, y + v * span / 2);
+      }
+    }
+    return keys;
+  }
+
+  // Samples the field at all the passed in lattice locations that have not
+  // been sampled yet. The field is queried concurrently.
+  template <typename Field>
+  void ensureSamples(std::vector<Key>& keys, const Field& field) {
+    keys.erase(std::remove_if(keys.begin(), keys.end(),
+                              [this](Key key) {
+                                return m_samples.count(key) != 0;
+                              }),
+               keys.end());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<float> values(keys.size());
+    const long numKeys = keys.size();
+#pragma omp parallel for schedule(dynamic, 64)
+    for (long k = 0; k < numKeys; ++k) {
+      Kernel::Point_3 location = latticeLocation(keys[k]);
+      values[k] = field(Kernel::Point_2(location.x(), location.y()));
+    }
+
+    m_samples.reserve(m_samples.size() + keys.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+      m_samples.emplace(keys[k], values[k]);
+      m_minHeight = std::min(m_minHeight, values[k]);
+      m_maxHeight = std::max(m_maxHeight, values[k]);
+    }
+  }
+
+  // Refines breadth first. All the tiles of a level are sampled in one batch
+  // before deciding which of them to split.
+  template <typename Field>
+  void refine(const Field& field) {
+    std::vector<Tile> candidates{Tile{0, 0, 0}};
+    std::vector<Tile> nextCandidates;
+    std::vector<Key> keys;
+    for (size_t level = 0; !candidates.empty(); ++level) {
+      if (level == m_params.max_depth) {
+        for (const Tile& tile : candidates) {
+          m_leaves.insert(tileKey(tile.level, tile.i, tile.j));
+        }
+        break;
+      }
+
+      keys.clear();
+      for (const Tile& tile : candidates) {
+        for (const auto& row : tileSamples(tile)) {
+          keys.insert(keys.end(), row.begin(), row.end());
+        }
+      }
+      ensureSamples(keys, field);
+
+      nextCandidates.clear();
+      for (const Tile& tile : candidates) {
+        if (level < m_params.min_depth || shouldRefine(tile)) {
+          for (std::uint64_t child = 0; child < 4; ++child) {
+            nextCandidates.push_back(Tile{level + 1, 2 * tile.i + (child & 1),
+                                          2 * tile.j + (child >> 1)});
+          }
+        } else {
+          m_leaves.insert(tileKey(tile.level, tile.i, tile.j));
+        }
+      }
+      std::swap(candidates, nextCandidates);
+    }
+  }
+
+  // The deviation of the field from the bilinear patch through the tile
+  // corners, at the tile center and edge midpoints.
+  bool shouldRefine(const Tile& tile) const {
+    TileSamples keys = tileSamples(tile);
+    float h[3][3];
+    for (int u = 0; u < 3; ++u) {
+      for (int v = 0; v < 3; ++v) {
+        h[u][v] = m_samples.at(keys[u][v]);
+      }
+    }
+    float deviation = 0;
+    for (int u = 0; u < 3; ++u) {
+      for (int v = 0; v < 3; ++v) {
+        if (u != 1 && v != 1) continue;
+        float su = u / 2.0f, sv = v / 2.0f;
+        float bilinear = (1 - su) * (1 - sv) * h[0][0] +
+                         su * (1 - sv) * h[2][0] + (1 - su) * sv * h[0][2] +
+                         su * sv * h[2][2];
+        deviation = std::max(deviation, std::abs(h[u][v] - bilinear));
+      }
+    }
+
+    if (!m_hasCamera) {
+      return deviation > m_params.variation_tolerance;
+    }
+    // Heights are displayed relative to the minimum sampled height.
+    Kernel::Point_3 center = latticeLocation(keys[1][1]);
+    Kernel::Point_3 displayed(center.x(), center.y(), h[1][1] - m_minHeight);
+    float distance = std::sqrt(CGAL::squared_distance(displayed, m_eye));
+    float tileSize = std::sqrt(std::max(m_uExtent.squared_length(),
+                                        m_vExtent.squared_length())) /
+                     (1 << tile.level);
+    // Tiles the camera is within are always refined.
+    if (distance <= tileSize) return true;
+    return deviation * m_pixelsPerRadian / distance > m_params.pixel_tolerance;
+  }
+
+  // Returns the level of the leaf covering the tile, or -1 if the tile is
+  // split further.
+  int coveringLeafLevel(const Tile& tile) const {
+    for (int level = tile.level; level >= 0; --level) {
+      size_t shift = tile.level - level;
+      if (m_leaves.count(tileKey(level, tile.i >> shift, tile.j >> shift))) {
+        return level;
+      }
+    }
+    return -1;
+  }
+
+  bool neighbour(const Tile& tile, int direction, Tile& neighbourTile) const {
+    static constexpr int OFFSETS[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+    std::int64_t i = tile.i + OFFSETS[direction][0];
+    std::int64_t j = tile.j + OFFSETS[direction][1];
+    std::int64_t tilesPerSide = static_cast<std::int64_t>(1) << tile.level;
+    if (i < 0 || j < 0 || i >= tilesPerSide || j >= tilesPerSide) {
+      return false;
+    }
+    neighbourTile = Tile{tile.level, static_cast<std::uint64_t>(i),
+                         static_cast<std::uint64_t>(j)};
+    return true;
+  }
+
+  // Splits leaves until neighbouring leaves differ by at most one level.
+  void balance() {
+    std::deque<Key> queue(m_leaves.begin(), m_leaves.end());
+    while (!queue.empty()) {
+      Key key = queue.front();
+      queue.pop_front();
+      if (!m_leaves.count(key)) continue;
+
+      Tile tile = tileFromKey(key);
+      for (int direction = 0; direction < 4; ++direction) {
+        Tile neighbourTile;
+        if (!neighbour(tile, direction, neighbourTile)) continue;
+        int level = coveringLeafLevel(neighbourTile);
+        if (level < 0 || level + 1 >= static_cast<int>(tile.level)) continue;
+
+        size_t shift = tile.level - level;
+        Tile coarse{static_cast<size_t>(level), neighbourTile.i >> shift,
+                    neighbourTile.j >> shift};
+        m_leaves.erase(tileKey(coarse.level, coarse.i, coarse.j));
+        for (std::uint64_t child = 0; child < 4; ++child) {
+          Key childKey = tileKey(coarse.level + 1, 2 * coarse.i + (child & 1),
+                                 2 * coarse.j + (child >> 1));
+          m_leaves.insert(childKey);
+          queue.push_back(childKey);
+        }
+        // The split may not have been enough for this tile.
+        queue.push_back(key);
+      }
+    }
+  }
+
+  template <typename Field>
+  void triangulate(const Field& field, IndexedTriangleMesh& mesh) {
+    std::vector<Key> leaves(m_leaves.begin(), m_leaves.end());
+    std::sort(leaves.begin(), leaves.end());
+
+    // Leaves created while balancing may miss samples
+    std::vector<Key> keys;
+    for (Key key : leaves) {
+      for (const auto& row : tileSamples(tileFromKey(key))) {
+        keys.insert(keys.end(), row.begin(), row.end());
+      }
+    }
+    ensureSamples(keys, field);
+
+    mesh.clear();
+    std::unordered_map<Key, IndexedTriangleMesh::IndexType> vertexIndices;
+    auto vertex = [this, &mesh, &vertexIndices](Key key) {
+      auto inserted = vertexIndices.emplace(key, 0);
+      if (inserted.second) {
+        Kernel::Point_3 location = latticeLocation(key);
+        inserted.first->second = mesh.addVertex(location.x(), location.y(),
+                                                m_samples.at(key));
+      }
+      return inserted.first->second;
+    };
+
+    // Boundary of a tile, counterclockwise from its lowest corner, in [u][v]
+    // half span offsets. Odd entries are edge midpoints, that are only used if
+    // the tile across the edge is finer. Entry b lies on the edge towards
+    // neighbour direction b / 2.
+    static constexpr int BOUNDARY[8][2] = {{0, 0}, {1, 0}, {2, 0}, {2, 1},
+                                           {2, 2}, {1, 2}, {0, 2}, {0, 1}};
+
+    for (Key key : leaves) {
+      Tile tile = tileFromKey(key);
+      TileSamples samples = tileSamples(tile);
+
+      std::vector<IndexedTriangleMesh::IndexType> boundary;
+      for (int b = 0; b < 8; ++b) {
+        if (b % 2 == 1) {
+          Tile neighbourTile;
+          if (!neighbour(tile, b / 2, neighbourTile) ||
+              coveringLeafLevel(neighbourTile) >= 0) {
+            continue;
+          }
+        }
+        boundary.push_back(vertex(samples[BOUNDARY[b][0]][BOUNDARY[b][1]]));
+      }
+
+      if (boundary.size() == 4) {
+        mesh.addTriangle(boundary[0], boundary[1], boundary[2]);
+        mesh.addTriangle(boundary[0], boundary[2], boundary[3]);
+      } else {
+        IndexedTriangleMesh::IndexType center = vertex(samples[1][1]);
+        for (size_t b = 0; b < boundary.size(); ++b) {
+          mesh.addTriangle(center, boundary[b],
+                           boundary[(b + 1) % boundary.size()]);
+        }
+      }
+    }
+  }
+
+  Kernel::Point_3 m_corner;
+  Kernel::Vector_3 m_uExtent;
+  Kernel::Vector_3 m_vExtent;
+  AdaptiveHeightFieldParams m_params;
+  std::uint64_t m_latticeSize;
+
+  bool m_hasCamera;
+  Kernel::Point_3 m_eye;
+  float m_pixelsPerRadian;
+
+  std::unordered_map<Key, float> m_samples;
+  std::unordered_set<Key> m_leaves;
+  float m_minHeight;
+  float m_maxHeight;
+};
+
+#endif  //_ADAPTIVE_HEIGHT_FIELD_H_
@@ -1,12 +1,25 @@
+#include <OGRE/OgreRoot.h>
+#include <OGRE/OgreViewport.h>
+
+#include <geometryInterop.h>
+
 #include "commonViewInteractionsHandler.h"
 
 CommonViewInteractionsHandler::CommonViewInteractionsHandler(
-    Ogre::SceneNode* parentNode)
-    : m_rootNode(parentNode->createChildSceneNode()),
+    Ogre::SceneNode* parentNode, const Ogre::Camera* camera)
+    : m_camera(camera),
+      m_rootNode(parentNode->createChildSceneNode()),
       m_levelSetNode(m_rootNode->createChildSceneNode()),
       m_heightFieldNode(m_rootNode->createChildSceneNode()),
       m_fieldLevelSetVisualizer(m_levelSetNode),
-      m_heightFieldVisualizer(m_heightFieldNode) {}
+      m_heightFieldVisualizer(m_heightFieldNode),
+      m_heightFieldShown(false) {
+  Ogre::Root::getSingleton().addFrameListener(this);
+}
+
+CommonViewInteractionsHandler::~CommonViewInteractionsHandler() {
+  Ogre::Root::getSingleton().removeFrameListener(this);
+}
 
 void CommonViewInteractionsHandler::levelSetSliderChanged(
     const CEGUI::EventArgs& eventArgs) {
@@ -16,10 +29,39 @@ void CommonViewInteractionsHandler::levelSetSliderChanged(
           ->getCurrentValue());
 }
 
+void CommonViewInteractionsHandler::nestedLevelSetSliderChanged(
+    const CEGUI::EventArgs& eventArgs) {
+  m_fieldLevelSetVisualizer.setNormalizedNumNestedLevels(
+      static_cast<CEGUI::Slider*>(
+          static_cast<const CEGUI::WindowEventArgs*>(&eventArgs)->window)
+          ->getCurrentValue());
+}
+
+void CommonViewInteractionsHandler::adaptiveHeightFieldToggled(
+    const CEGUI::EventArgs& eventArgs) {
+  m_heightFieldVisualizer.setAdaptive(
+      static_cast<CEGUI::ToggleButton*>(
+          static_cast<const CEGUI::WindowEventArgs*>(&eventArgs)->window)
+          ->isSelected());
+}
+
+bool CommonViewInteractionsHandler::frameStarted(
+    const Ogre::FrameEvent& /**/) {
+  const Ogre::Viewport* viewport = m_camera->getViewport();
+  if (!m_heightFieldShown || !viewport) return true;
+  // The height field nodes are not transformed, so world coordinates are
+  // those of the height field.
+  m_heightFieldVisualizer.setCamera(
+      GeometryInterop::geomPointFromRendering(m_camera->getDerivedPosition()),
+      viewport->getActualHeight() / m_camera->getFOVy().valueRadians());
+  return true;
+}
+
 void CommonViewInteractionsHandler::fieldChanged(
     const SquaredDistField_3* inducedField) {
   m_fieldLevelSetVisualizer.setField(inducedField);
   m_heightFieldNode->setVisible(false);
+  m_heightFieldShown = false;
   m_levelSetNode->setVisible(true);
 }
 
@@ -28,4 +70,5 @@ void CommonViewInteractionsHandler::fieldChanged(
   m_heightFieldVisualizer.setField(inducedField);
   m_levelSetNode->setVisible(false);
   m_heightFieldNode->setVisible(true);
+  m_heightFieldShown = true;
 }
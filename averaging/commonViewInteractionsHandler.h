@@ -2,27 +2,39 @@
 #define _AVERAGING_COMMON_VIEW_INTERACTIONS_HANDLER_H_
 
 #include <CEGUI/CEGUI.h>
+#include <OGRE/OgreCamera.h>
+#include <OGRE/OgreFrameListener.h>
 #include <OGRE/OgreSceneNode.h>
 
 #include "commonViewInterface.h"
 #include "fieldLevelSetVisualizer.h"
 #include "heightFieldVisualizer.h"
 
-class CommonViewInteractionsHandler {
+// Also follows the camera every frame, as it drives the refinement of the
+// adaptive height field.
+class CommonViewInteractionsHandler : public Ogre::FrameListener {
  public:
-  CommonViewInteractionsHandler(Ogre::SceneNode* parentNode);
+  CommonViewInteractionsHandler(Ogre::SceneNode* parentNode,
+                                const Ogre::Camera* camera);
+  ~CommonViewInteractionsHandler();
   void levelSetSliderChanged(const CEGUI::EventArgs& eventArg);
+  void nestedLevelSetSliderChanged(const CEGUI::EventArgs& eventArg);
+  void adaptiveHeightFieldToggled(const CEGUI::EventArgs& eventArg);
+
+  bool frameStarted(const Ogre::FrameEvent& frameEvent) override;
 
   void fieldChanged(const SquaredDistField_3* inducedField);
 
   void fieldChanged(const SquaredDistField_2* inducedField);
 
  private:
+  const Ogre::Camera* m_camera;
   Ogre::SceneNode* m_rootNode;
   Ogre::SceneNode* m_levelSetNode;
   Ogre::SceneNode* m_heightFieldNode;
   LevelSetMeshVisualizer<SquaredDistField_3> m_fieldLevelSetVisualizer;
   HeightFieldVisualizer<SquaredDistField_2> m_heightFieldVisualizer;
+  bool m_heightFieldShown;
 };
 
 #endif  //_AVERAGING_COMMON_VIEW_INTERACTIONS_HANDLER_H_
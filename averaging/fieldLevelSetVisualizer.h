@@ -1,6 +1,8 @@
 #ifndef _FIELD_LEVEL_SET_VISUALIZER_H_
 #define _FIELD_LEVEL_SET_VISUALIZER_H_
 
+#include <cmath>
+
 #include <OGRE/OgreEntity.h>
 #include <OGRE/OgreSceneManager.h>
 #include <OGRE/OgreSceneNode.h>
@@ -8,19 +10,31 @@
 #include <appContext.h>
 #include <dynamicMeshManager.h>
 #include <geometryTypes.h>
+#include <indexedTriangleMesh.h>
 
 #include "levelSetMeshBuilder.h"
+#include "multiLevelSetExtractor.h"
 
 // View class that allows for rendering level sets of field.
 template <class Field>
 class LevelSetMeshVisualizer {
   static constexpr Kernel::FT MAX_LEVEL = 20;
   static constexpr Kernel::FT MIN_LEVEL = 1;
+  // Squared radius of the sphere about the origin level sets are meshed in
+  static constexpr Kernel::FT LEVEL_SET_BOUNDING_SQUARED_RADIUS = 100;
+  // Resolution of the grid nested level sets are extracted from, over the
+  // cube that bounds the same sphere.
+  static constexpr size_t NESTED_LEVEL_SET_RESOLUTION = 128;
+  static constexpr size_t MAX_NESTED_LEVELS = 10;
 
  public:
   LevelSetMeshVisualizer(Ogre::SceneNode* parent)
       : m_inducedField(nullptr),
-        m_levelSetSceneNode(parent->createChildSceneNode()) {
+        m_levelSetSceneNode(parent->createChildSceneNode()),
+        m_nestedLevelSetExtractor(nestedLevelSetBounds(),
+                                  NESTED_LEVEL_SET_RESOLUTION),
+        m_nestedLevelSetSamplesValid(false),
+        m_numNestedLevels(0) {
     setNormalizedLevel(0.1);
   }
 
@@ -29,17 +43,48 @@ class LevelSetMeshVisualizer {
     addLevelSetMeshToScene();
   }
 
+  // Sets the number of nested level sets shown along with the current level,
+  // from none, up to MAX_NESTED_LEVELS. Only the nested level sets are
+  // rebuilt.
+  void setNormalizedNumNestedLevels(Kernel::FT value) {
+    m_numNestedLevels = std::lround(MAX_NESTED_LEVELS * value);
+    clearMeshes(m_nestedLevelSetMeshes);
+    addNestedLevelSetMeshesToScene(m_numNestedLevels);
+  }
+
   void setField(const Field* inducedField) {
     m_inducedField = inducedField;
+    m_nestedLevelSetSamplesValid = false;
     clearLevelSetMeshes();
     addLevelSetMeshToScene();
+    addNestedLevelSetMeshesToScene(m_numNestedLevels);
   }
 
   void clearLevelSetMeshes() {
-    for (auto levelSetMesh : m_levelSetMeshes) {
-      m_levelSetSceneNode->getCreator()->destroyEntity(levelSetMesh);
+    clearMeshes(m_levelSetMeshes);
+    clearMeshes(m_nestedLevelSetMeshes);
+  }
+
+  // Adds numLevels level sets, evenly spaced over (MIN_LEVEL, MAX_LEVEL]. All
+  // of them are extracted in one sweep over a grid of field samples, which is
+  // reused until the field changes.
+  void addNestedLevelSetMeshesToScene(size_t numLevels) {
+    if (!m_inducedField || numLevels == 0) return;
+
+    if (!m_nestedLevelSetSamplesValid) {
+      m_nestedLevelSetExtractor.sampleField(*m_inducedField);
+      m_nestedLevelSetSamplesValid = true;
+    }
+
+    std::vector<FieldType> levels(numLevels);
+    for (size_t i = 0; i < numLevels; ++i) {
+      levels[i] = MIN_LEVEL + (MAX_LEVEL - MIN_LEVEL) * (i + 1) / numLevels;
+    }
+
+    for (const auto& mesh : m_nestedLevelSetExtractor.extract(levels)) {
+      if (mesh.empty()) continue;
+      addMeshToScene(mesh, m_nestedLevelSetMeshes);
     }
-    m_levelSetMeshes.clear();
   }
 
   void addLevelSetMeshToScene() {
@@ -51,25 +96,55 @@ class LevelSetMeshVisualizer {
       return inducedFieldCRef.get()(point) - m_value;
     };
 
-    LevelSetMeshBuilder<> meshBuilder;
-    CGAL::Polyhedron_3<Kernel> meshRep;
-    meshBuilder.buildMesh(samplingFunction, Kernel::Sphere_3(CGAL::ORIGIN, 100),
-                          1, meshRep);
+    IndexedTriangleMesh meshRep;
+    m_meshBuilder.buildMesh(
+        samplingFunction,
+        Kernel::Sphere_3(CGAL::ORIGIN, LEVEL_SET_BOUNDING_SQUARED_RADIUS), 1,
+        meshRep);
+    addMeshToScene(meshRep, m_levelSetMeshes);
+  }
 
+ private:
+  void addMeshToScene(const IndexedTriangleMesh& meshRep,
+                      std::vector<Ogre::Entity*>& meshes) {
     Ogre::Entity* levelSetMeshEntity =
         Framework::AppContext::getDynamicMeshManager().addMesh(
             meshRep, m_levelSetSceneNode);
     levelSetMeshEntity->setMaterialName(
         "Materials/DefaultTransparentTriangles");
 
-    m_levelSetMeshes.push_back(levelSetMeshEntity);
+    meshes.push_back(levelSetMeshEntity);
+  }
+
+  void clearMeshes(std::vector<Ogre::Entity*>& meshes) {
+    for (auto levelSetMesh : meshes) {
+      m_levelSetSceneNode->getCreator()->destroyEntity(levelSetMesh);
+    }
+    meshes.clear();
+  }
+
+  static Kernel::Iso_cuboid_3 nestedLevelSetBounds() {
+    const Kernel::FT extent = std::sqrt(LEVEL_SET_BOUNDING_SQUARED_RADIUS);
+    return Kernel::Iso_cuboid_3(Kernel::Point_3(-extent, -extent, -extent),
+                                Kernel::Point_3(extent, extent, extent));
   }
 
- private:
   Kernel::FT m_value;
   Ogre::SceneNode* m_levelSetSceneNode;
+  // Meshes of the current level, and of the nested levels
   std::vector<Ogre::Entity*> m_levelSetMeshes;
+  std::vector<Ogre::Entity*> m_nestedLevelSetMeshes;
   const Field* m_inducedField;
+  // Held across builds, so that writing out generated meshes does not block
+  // the next build.
+  LevelSetMeshBuilder<> m_meshBuilder;
+  MultiLevelSetExtractor m_nestedLevelSetExtractor;
+  bool m_nestedLevelSetSamplesValid;
+  size_t m_numNestedLevels;
 };
 
+template <class Field>
+constexpr Kernel::FT
+    LevelSetMeshVisualizer<Field>::LEVEL_SET_BOUNDING_SQUARED_RADIUS;
+
 #endif  //_FIELD_LEVEL_SET_VISUALIZER_H_
@@ -0,0 +1,230 @@
+#include <cstddef>
+#include <cstdint>
+
+#include <OGRE/OgreCamera.h>
+#include <OGRE/OgreHardwareBufferManager.h>
+
+#include "heightFieldRenderable.h"
+
+namespace {
+// Interleaved layout of the vertex buffer.
+struct HeightFieldVertex {
+  float position[3];
+  Ogre::RGBA colour;
+};
+
+constexpr unsigned short VERTEX_BINDING = 0;
+constexpr size_t INDICES_PER_QUAD = 6;
+
+// Alternate green and blue stripes of increasing intensity along the height.
+Ogre::ColourValue heightColour(float normalizedHeight) {
+  if (static_cast<int>(normalizedHeight / 0.005) % 2 == 0) {
+    return Ogre::ColourValue(0, normalizedHeight, 0);
+  }
+  return Ogre::ColourValue(0, 0, 1 - normalizedHeight);
+}
+}  // end anonymous namespace
+
+HeightFieldRenderable::HeightFieldRenderable(const std::string& materialName)
+    : m_uSamples(0),
+      m_vSamples(0),
+      m_colourType(Ogre::VertexElement::getBestColourVertexElementType()),
+      m_boundingRadius(0) {
+  mRenderOp.operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  mRenderOp.useIndexes = true;
+  mRenderOp.vertexData = new Ogre::VertexData();
+  mRenderOp.indexData = new Ogre::IndexData();
+
+  Ogre::VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+  decl->addElement(VERTEX_BINDING, offsetof(HeightFieldVertex, position),
+                   Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+  decl->addElement(VERTEX_BINDING, offsetof(HeightFieldVertex, colour),
+                   m_colourType, Ogre::VES_DIFFUSE);
+
+  setMaterial(materialName);
+}
+
+HeightFieldRenderable::~HeightFieldRenderable() {
+  delete mRenderOp.vertexData;
+  delete mRenderOp.indexData;
+}
+
+void HeightFieldRenderable::setGridSize(size_t uSamples, size_t vSamples) {
+  if (uSamples == m_uSamples && vSamples == m_vSamples) return;
+  m_uSamples = uSamples;
+  m_vSamples = vSamples;
+
+  reserveVertices(m_uSamples * m_vSamples);
+  buildIndexBuffer();
+}
+
+void HeightFieldRenderable::reserveVertices(size_t numVertices) {
+  Ogre::VertexData* vertexData = mRenderOp.vertexData;
+  vertexData->vertexStart = 0;
+  vertexData->vertexCount = numVertices;
+  Ogre::VertexBufferBinding* binding = vertexData->vertexBufferBinding;
+  if (binding->isBufferBound(VERTEX_BINDING) &&
+      binding->getBuffer(VERTEX_BINDING)->getNumVertices() >= numVertices) {
+    return;
+  }
+  if (numVertices == 0) return;
+  Ogre::HardwareVertexBufferSharedPtr vbuf =
+      Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+          sizeof(HeightFieldVertex), numVertices,
+          Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+  binding->setBinding(VERTEX_BINDING, vbuf);
+}
+
+void HeightFieldRenderable::buildIndexBuffer() {
+  Ogre::IndexData* indexData = mRenderOp.indexData;
+  indexData->indexStart = 0;
+  indexData->indexCount = 0;
+  if (m_uSamples < 2 || m_vSamples < 2) return;
+
+  const size_t uQuads = m_uSamples - 1;
+  const long vQuads = m_vSamples - 1;
+  indexData->indexCount = uQuads * vQuads * INDICES_PER_QUAD;
+  indexData->indexBuffer =
+      Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+          Ogre::HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
+          Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+
+  std::uint32_t* indices = static_cast<std::uint32_t*>(
+      indexData->indexBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+#pragma omp parallel for schedule(static)
+  for (long v = 0; v < vQuads; ++v) {
+    std::uint32_t* quadIndices = indices + v * uQuads * INDICES_PER_QUAD;
+    for (size_t u = 0; u < uQuads; ++u) {
+      std::uint32_t corner = v * m_uSamples + u;
+      *quadIndices++ = corner;
+      *quadIndices++ = corner + 1;
+      *quadIndices++ = corner + m_uSamples + 1;
+      *quadIndices++ = corner;
+      *quadIndices++ = corner + m_uSamples + 1;
+      *quadIndices++ = corner + m_uSamples;
+    }
+  }
+  indexData->indexBuffer->unlock();
+}
+
+void HeightFieldRenderable::setHeights(const Ogre::Vector3& firstSample,
+                                       const Ogre::Vector3& uIncrement,
+                                       const Ogre::Vector3& vIncrement,
+                                       const float* heights, float minHeight,
+                                       float maxHeight) {
+  if (mRenderOp.vertexData->vertexCount == 0) return;
+
+  float heightRange = maxHeight - minHeight;
+  heightRange = heightRange == 0 ? 1 : heightRange;
+
+  Ogre::HardwareVertexBufferSharedPtr vbuf =
+      mRenderOp.vertexData->vertexBufferBinding->getBuffer(VERTEX_BINDING);
+  HeightFieldVertex* vertices = static_cast<HeightFieldVertex*>(
+      vbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+  const long vSamples = m_vSamples;
+#pragma omp parallel for schedule(static)
+  for (long v = 0; v < vSamples; ++v) {
+    Ogre::Vector3 rowStart = firstSample + vIncrement * v;
+    HeightFieldVertex* rowVertices = vertices + v * m_uSamples;
+    const float* rowHeights = heights + v * m_uSamples;
+    for (size_t u = 0; u < m_uSamples; ++u) {
+      Ogre::Vector3 location = rowStart + uIncrement * u;
+      float height = rowHeights[u] - minHeight;
+      rowVertices[u].position[0] = location.x;
+      rowVertices[u].position[1] = location.y;
+      rowVertices[u].position[2] = height;
+      rowVertices[u].colour = Ogre::VertexElement::convertColourValue(
+          heightColour(height / heightRange), m_colourType);
+    }
+  }
+  vbuf->unlock();
+
+  // Bounds are those of the xy projected grid, lifted by the height range.
+  Ogre::Vector3 corners[] = {
+      firstSample, firstSample + uIncrement * (m_uSamples - 1),
+      firstSample + vIncrement * (m_vSamples - 1),
+      firstSample + uIncrement * (m_uSamples - 1) +
+          vIncrement * (m_vSamples - 1)};
+  Ogre::AxisAlignedBox boundingBox;
+  for (const auto& corner : corners) {
+    boundingBox.merge(Ogre::Vector3(corner.x, corner.y, 0));
+    boundingBox.merge(Ogre::Vector3(corner.x, corner.y, maxHeight - minHeight));
+  }
+  setBounds(boundingBox);
+}
+
+void HeightFieldRenderable::setMesh(const IndexedTriangleMesh& mesh,
+                                    float minHeight, float maxHeight) {
+  // The grid topology no longer holds
+  m_uSamples = 0;
+  m_vSamples = 0;
+
+  float heightRange = maxHeight - minHeight;
+  heightRange = heightRange == 0 ? 1 : heightRange;
+
+  reserveVertices(mesh.numVertices());
+  Ogre::AxisAlignedBox boundingBox;
+  if (mesh.numVertices() > 0) {
+    Ogre::HardwareVertexBufferSharedPtr vbuf =
+        mRenderOp.vertexData->vertexBufferBinding->getBuffer(VERTEX_BINDING);
+    HeightFieldVertex* vertices = static_cast<HeightFieldVertex*>(
+        vbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
+    const float* positions = mesh.positions().data();
+    const long numVertices = mesh.numVertices();
+#pragma omp parallel for schedule(static)
+    for (long v = 0; v < numVertices; ++v) {
+      const float* position = positions + 3 * v;
+      float height = position[2] - minHeight;
+      vertices[v].position[0] = position[0];
+      vertices[v].position[1] = position[1];
+      vertices[v].position[2] = height;
+      vertices[v].colour = Ogre::VertexElement::convertColourValue(
+          heightColour(height / heightRange), m_colourType);
+    }
+    vbuf->unlock();
+
+    for (long v = 0; v < numVertices; ++v) {
+      boundingBox.merge(Ogre::Vector3(positions[3 * v],
+                                      positions[3 * v + 1],
+                                      positions[3 * v + 2] - minHeight));
+    }
+  }
+
+  // The topology changes from update to update, so the index buffer is
+  // dynamic, and only grows.
+  Ogre::IndexData* indexData = mRenderOp.indexData;
+  indexData->indexStart = 0;
+  indexData->indexCount = mesh.indices().size();
+  if (indexData->indexCount > 0) {
+    if (indexData->indexBuffer.isNull() ||
+        indexData->indexBuffer->getUsage() !=
+            Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE ||
+        indexData->indexBuffer->getNumIndexes() < indexData->indexCount) {
+      indexData->indexBuffer =
+          Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+              Ogre::HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
+              Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+    }
+    indexData->indexBuffer->writeData(
+        0, indexData->indexCount * sizeof(IndexedTriangleMesh::IndexType),
+        mesh.indices().data(), true);
+  }
+
+  setBounds(boundingBox);
+}
+
+void HeightFieldRenderable::setBounds(const Ogre::AxisAlignedBox& boundingBox) {
+  setBoundingBox(boundingBox);
+  m_boundingRadius =
+      boundingBox.isFinite() ? boundingBox.getHalfSize().length() : 0;
+}
+
+Ogre::Real HeightFieldRenderable::getSquaredViewDepth(
+    const Ogre::Camera* cam) const {
+  Ogre::Vector3 center = mParentNode->_getDerivedPosition() + mBox.getCenter();
+  return (center - cam->getDerivedPosition()).squaredLength();
+}
+
+Ogre::Real HeightFieldRenderable::getBoundingRadius() const {
+  return m_boundingRadius;
+}
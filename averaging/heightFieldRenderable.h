@@ -0,0 +1,54 @@
+#ifndef _HEIGHT_FIELD_RENDERABLE_H_
+#define _HEIGHT_FIELD_RENDERABLE_H_
+
+#include <string>
+
+#include <OGRE/OgreSimpleRenderable.h>
+
+#include <indexedTriangleMesh.h>
+
+// Renders a regular grid of height samples as a triangle mesh. Vertices
+// (position and packed colour, interleaved) live in a single dynamic hardware
+// buffer that is rewritten in place on every update. The grid topology only
+// depends on the resolution, and lives in a static 32-bit index buffer that is
+// rebuilt only when the resolution changes.
+//
+// Alternatively, an arbitrary triangulation of height samples, such as an
+// adaptively refined one, may be set as an indexed mesh.
+class HeightFieldRenderable : public Ogre::SimpleRenderable {
+ public:
+  HeightFieldRenderable(const std::string& materialName);
+  ~HeightFieldRenderable();
+
+  // Set the number of samples along the u and v directions of the grid.
+  void setGridSize(size_t uSamples, size_t vSamples);
+
+  // Writes out the vertices of the grid. The sample (u, v) is located at the
+  // xy projection of firstSample + u * uIncrement + v * vIncrement, and lifted
+  // along z by its height above minHeight. heights are laid out u fastest, and
+  // must hold as many samples as the grid.
+  void setHeights(const Ogre::Vector3& firstSample,
+                  const Ogre::Vector3& uIncrement,
+                  const Ogre::Vector3& vIncrement, const float* heights,
+                  float minHeight, float maxHeight);
+
+  // Renders the mesh, whose vertices are (x, y, height) triples. Heights are
+  // lifted by their height above minHeight.
+  void setMesh(const IndexedTriangleMesh& mesh, float minHeight,
+               float maxHeight);
+
+  Ogre::Real getSquaredViewDepth(const Ogre::Camera* cam) const override;
+  Ogre::Real getBoundingRadius() const override;
+
+ private:
+  void reserveVertices(size_t numVertices);
+  void buildIndexBuffer();
+  void setBounds(const Ogre::AxisAlignedBox& boundingBox);
+
+  size_t m_uSamples;
+  size_t m_vSamples;
+  Ogre::VertexElementType m_colourType;
+  Ogre::Real m_boundingRadius;
+};
+
+#endif  //_HEIGHT_FIELD_RENDERABLE_H_
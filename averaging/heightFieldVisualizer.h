@@ -1,15 +1,23 @@
 #ifndef _HEIGHT_FIELD_VISUALIZER_H_
 #define _HEIGHT_FIELD_VISUALIZER_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include <CGAL/Plane_3.h>
 
-#include <OGRE/OgreEntity.h>
-#include <OGRE/OgreManualObject.h>
 #include <OGRE/OgreSceneManager.h>
 #include <OGRE/OgreSceneNode.h>
 
+#include <geometryInterop.h>
 #include <uniformPlanarGrid.h>
 
+#include "adaptiveHeightField.h"
+#include "heightFieldRenderable.h"
+
 // TODO msati3: Move this to protobuf
 struct HeightFieldVisualizationParams {
   HeightFieldVisualizationParams()
@@ -18,18 +26,27 @@ struct HeightFieldVisualizationParams {
         x_res(1000),
         y_res(1000),
         x_extent(10),
-        y_extent(10) {}
+        y_extent(10),
+        adaptive(false) {}
 
   Kernel::Plane_3 plane;
   size_t x_res;
   size_t y_res;
   float x_extent;
   float y_extent;
+  // If set, the height field is sampled on an adaptive quadtree over the
+  // extents instead of the x_res by y_res grid.
+  bool adaptive;
+  AdaptiveHeightFieldParams adaptive_params;
 };
 
 // Visualize a planar section of a scalar field as a height field.
 template <class Field>
 class HeightFieldVisualizer {
+  // Fraction of the distance of the eye to the plane it has to move by, for
+  // the adaptive mode to refine anew.
+  static constexpr float CAMERA_MOVE_FRACTION = 0.1;
+
  public:
   HeightFieldVisualizer(
       Ogre::SceneNode* parent,
@@ -37,7 +54,16 @@ class HeightFieldVisualizer {
           HeightFieldVisualizationParams())
       : m_visParams(visualizationParams),
         m_heightFieldSceneNode(parent->createChildSceneNode()),
-        m_heightFieldObject(nullptr) {}
+        m_inducedField(nullptr),
+        m_heightFieldRenderable(
+            new HeightFieldRenderable("Materials/HeightField")),
+        m_hasCamera(false) {
+    m_heightFieldSceneNode->attachObject(m_heightFieldRenderable.get());
+  }
+
+  ~HeightFieldVisualizer() {
+    m_heightFieldSceneNode->detachObject(m_heightFieldRenderable.get());
+  }
 
   void setPlane(const Kernel::Plane_3& plane) {
     m_visParams.plane = plane;
@@ -49,68 +75,104 @@ class HeightFieldVisualizer {
     recomputeVisualization();
   }
 
+  void setAdaptive(bool adaptive) {
+    if (m_visParams.adaptive == adaptive) return;
+    m_visParams.adaptive = adaptive;
+    recomputeVisualization();
+  }
+
+  // The camera drives the refinement of the adaptive mode. pixelsPerRadian is
+  // the viewport size in pixels over its field of view. Refinement changes
+  // little over small camera moves, and thus, the adaptive mode is only
+  // recomputed once the eye moves by CAMERA_MOVE_FRACTION of its distance to
+  // the plane, or the viewport changes.
+  void setCamera(const Kernel::Point_3& eye, float pixelsPerRadian) {
+    if (m_hasCamera && pixelsPerRadian == m_pixelsPerRadian) {
+      const Kernel::FT moveTolerance =
+          CAMERA_MOVE_FRACTION *
+          std::sqrt(CGAL::squared_distance(m_eye, m_visParams.plane));
+      if (CGAL::squared_distance(eye, m_eye) <= moveTolerance * moveTolerance) {
+        return;
+      }
+    }
+    m_hasCamera = true;
+    m_eye = eye;
+    m_pixelsPerRadian = pixelsPerRadian;
+    if (m_visParams.adaptive) recomputeVisualization();
+  }
+
   void recomputeVisualization() {
+    if (!m_inducedField) return;
+
     UniformPlanarGrid planarGrid(m_visParams.plane, m_visParams.x_res,
                                  m_visParams.y_res, m_visParams.x_extent,
                                  m_visParams.y_extent);
-
-    std::function<Kernel::FT(const Kernel::Point_2&)> samplingFunction =
-        [ this, inducedFieldCRef =
-                    std::cref(*m_inducedField) ](const Kernel::Point_2& point) {
-      return inducedFieldCRef.get()(point);
-    };
-
-    std::vector<std::tuple<Kernel::Point_2, float>> gridSamples;
-    gridSamples.reserve(planarGrid.size());
-    for (auto iter = planarGrid.begin(); iter != planarGrid.end(); ++iter) {
-      Kernel::Point_2 pointPlanar = Kernel::Point_2((*iter)[0], (*iter)[1]);
-      Kernel::FT sample = samplingFunction(pointPlanar);
-      gridSamples.push_back(std::make_tuple(pointPlanar, sample));
-    }
-
-    if (m_heightFieldObject != nullptr) {
-      m_heightFieldSceneNode->getCreator()->destroyManualObject(
-          m_heightFieldObject);
+    if (m_visParams.adaptive) {
+      recomputeAdaptiveVisualization(planarGrid);
+      return;
     }
 
-    m_heightFieldObject =
-        m_heightFieldSceneNode->getCreator()->createManualObject("heightField");
-    m_heightFieldObject->begin("Materials/PassThrough",
-                               Ogre::RenderOperation::OT_POINT_LIST);
-
-    auto minMaxEntries =
-        std::minmax_element(gridSamples.begin(), gridSamples.end(),
-                            [](const auto& first, const auto& second) {
-                              return std::get<1>(first) < std::get<1>(second);
-                            });
-    auto minMaxValue = std::make_pair(std::get<1>(*minMaxEntries.first),
-                                      std::get<1>(*minMaxEntries.second));
-
-    float normalizingFactor = minMaxValue.second - minMaxValue.first;
-    normalizingFactor = normalizingFactor == 0 ? 1 : normalizingFactor;
-
-    for (const auto& gridSampleTuple : gridSamples) {
-      m_heightFieldObject->position(
-          std::get<0>(gridSampleTuple).x(), std::get<0>(gridSampleTuple).y(),
-          std::get<1>(gridSampleTuple) - minMaxValue.first);
-      float colorValue = (std::get<1>(gridSampleTuple) - minMaxValue.first) /
-                         normalizingFactor;
-      if ((int)(colorValue / 0.005) % 2 == 0) {
-        m_heightFieldObject->colour(Ogre::ColourValue(0, colorValue, 0));
-      } else {
-        m_heightFieldObject->colour(Ogre::ColourValue(0, 0, 1 - colorValue));
+    // Sample rows in parallel, straight into the height buffer. Each thread
+    // lays out the coordinates of a row of samples contiguously first, so
+    // that the point computations vectorize. Min and max heights are reduced
+    // alongside.
+    const Field& field = *m_inducedField;
+    const size_t xRes = planarGrid.xSamples();
+    const long yRes = planarGrid.ySamples();
+    m_heights.resize(xRes * yRes);
+    float minHeight = std::numeric_limits<float>::max();
+    float maxHeight = std::numeric_limits<float>::lowest();
+#pragma omp parallel reduction(min : minHeight) reduction(max : maxHeight)
+    {
+      std::vector<FieldType> xs(xRes), ys(xRes), zs(xRes);
+#pragma omp for schedule(static)
+      for (long v = 0; v < yRes; ++v) {
+        planarGrid.fillTileCoordinates(
+            UniformPlanarGrid::Tile{0, xRes, size_t(v), size_t(v) + 1},
+            xs.data(), ys.data(), zs.data());
+        float* rowHeights = m_heights.data() + v * xRes;
+        for (size_t u = 0; u < xRes; ++u) {
+          float height = field(Kernel::Point_2(xs[u], ys[u]));
+          rowHeights[u] = height;
+          minHeight = std::min(minHeight, height);
+          maxHeight = std::max(maxHeight, height);
+        }
       }
     }
-    m_heightFieldObject->end();
 
-    m_heightFieldSceneNode->attachObject(m_heightFieldObject);
+    m_heightFieldRenderable->setGridSize(xRes, yRes);
+    m_heightFieldRenderable->setHeights(
+        GeometryInterop::renderingFromGeom(planarGrid.point(0, 0)),
+        GeometryInterop::renderingFromGeom(planarGrid.uIncrement()),
+        GeometryInterop::renderingFromGeom(planarGrid.vIncrement()),
+        m_heights.data(),
+        minHeight, maxHeight);
   }
 
  private:
+  void recomputeAdaptiveVisualization(const UniformPlanarGrid& planarGrid) {
+    std::vector<Kernel::Point_3> corners = planarGrid.gridCorners();
+    AdaptiveHeightField heightField(corners[0], corners[1] - corners[0],
+                                    corners[3] - corners[0],
+                                    m_visParams.adaptive_params);
+    if (m_hasCamera) {
+      heightField.setCamera(m_eye, m_pixelsPerRadian);
+    }
+    heightField.build(*m_inducedField, m_adaptiveMesh);
+    m_heightFieldRenderable->setMesh(m_adaptiveMesh, heightField.minHeight(),
+                                     heightField.maxHeight());
+  }
+
+  HeightFieldVisualizationParams m_visParams;
   Ogre::SceneNode* m_heightFieldSceneNode;
   const Field* m_inducedField;
-  HeightFieldVisualizationParams m_visParams;
-  Ogre::ManualObject* m_heightFieldObject;
+  // Reused across recomputations to avoid reallocating
+  std::vector<float> m_heights;
+  IndexedTriangleMesh m_adaptiveMesh;
+  std::unique_ptr<HeightFieldRenderable> m_heightFieldRenderable;
+  bool m_hasCamera;
+  Kernel::Point_3 m_eye;
+  float m_pixelsPerRadian;
 };
 
 #endif  //_HEIGHT_FIELD_VISUALIZER_H_
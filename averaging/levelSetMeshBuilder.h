@@ -2,14 +2,13 @@
 #define _LEVEL_SET_MESH_BUILDER_H_
 
 #include <type_traits>
-#include <fstream>
+#include <unordered_map>
 
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 
 #include <CGAL/Delaunay_triangulation_cell_base_with_circumcenter_3.h>
 #include <CGAL/Delaunay_triangulation_3.h>
-#include <CGAL/IO/Complex_2_in_triangulation_3_file_writer.h>
 #include <CGAL/IO/output_surface_facets_to_polyhedron.h>
 #include <CGAL/Implicit_surface_3.h>
 #include <CGAL/make_surface_mesh.h>
@@ -18,9 +17,13 @@
 #include <CGAL/Surface_mesh_complex_2_in_triangulation_3.h>
 
 #include "geometryTypes.h"
+#include "indexedTriangleMesh.h"
+#include "plyMeshWriter.h"
 
-// If this flag is set, we write the level set mesh out to a .off file
+// If this flag is set, we write the level set mesh out to a binary .ply file at
+// the generated_level_set_mesh_path
 DECLARE_bool(write_generated_level_set_mesh);
+DECLARE_string(generated_level_set_mesh_path);
 
 // A scalar field sampling function must model this concept
 template <typename KernelType>
@@ -128,6 +131,10 @@ class ScalarFieldSamplingAdaptor<Kernel> {
 // a value), a bounding sphere within which the scalar field is to be sampled,
 // and a level set value, generates a mesh that corresponds to the level set
 // value.
+//
+// Generated meshes are written out on a background thread. The builder waits
+// for a pending write when it is destroyed, so it should be kept alive across
+// builds to not block on the write.
 template <typename BuildPolicy = DefaultLevelSetMeshBuilderPolicy>
 class LevelSetMeshBuilder : public BuildPolicy {
  private:
@@ -142,7 +149,42 @@ class LevelSetMeshBuilder : public BuildPolicy {
                  CGAL::Polyhedron_3<Kernel>& polyhedron) {
     Triangulation triangulation;
     InternalRepresentation rep(triangulation);
+    meshLevelSet(fieldSamplingFunction, boundingSphere, rep);
 
+    if (FLAGS_write_generated_level_set_mesh) {
+      IndexedTriangleMesh mesh;
+      extractIndexedMesh(fieldSamplingFunction, rep, mesh);
+      writeMesh(std::move(mesh));
+    }
+
+    CGAL::output_surface_facets_to_polyhedron(rep, polyhedron);
+  }
+
+  // Builds the level set mesh directly into flat, indexed buffers. This skips
+  // the construction of the halfedge data structure, and shares vertices
+  // between facets, which makes the output suitable for direct GPU upload.
+  void buildMesh(const SamplingFunction& fieldSamplingFunction,
+                 const Kernel::Sphere_3& boundingSphere, double value,
+                 IndexedTriangleMesh& mesh) {
+    Triangulation triangulation;
+    InternalRepresentation rep(triangulation);
+    meshLevelSet(fieldSamplingFunction, boundingSphere, rep);
+
+    extractIndexedMesh(fieldSamplingFunction, rep, mesh);
+
+    if (FLAGS_write_generated_level_set_mesh) {
+      writeMesh(mesh);
+    }
+  }
+
+ private:
+  using Cell_handle = typename Triangulation::Cell_handle;
+  using Facet = typename Triangulation::Facet;
+  using TrianglePoint = typename Triangulation::Point;
+
+  void meshLevelSet(const SamplingFunction& fieldSamplingFunction,
+                    const Kernel::Sphere_3& boundingSphere,
+                    InternalRepresentation& rep) {
     // TODO msati3: Extensible form of this to allow not just sampling
     // implicit functions possible?
     ScalarFieldSamplingAdaptor<typename BuildPolicy::DesiredSamplingKernel>
@@ -156,16 +198,80 @@ class LevelSetMeshBuilder : public BuildPolicy {
 
     LOG(INFO)
         << "Created level set mesh. Number of vertices in the created mesh = "
-        << triangulation.number_of_vertices();
+        << rep.triangulation().number_of_vertices();
+  }
 
-    if (FLAGS_write_generated_level_set_mesh) {
-      LOG(INFO) << "Writing generated mesh to mesh.off file";
-      std::ofstream out("mesh.off");
-      CGAL::output_surface_facets_to_off(out, rep);
+  void writeMesh(IndexedTriangleMesh mesh) {
+    LOG(INFO) << "Writing generated mesh to "
+              << FLAGS_generated_level_set_mesh_path;
+    m_meshWriter.writeAsync(std::move(mesh),
+                            FLAGS_generated_level_set_mesh_path);
+  }
+
+  // Walks the facets of the complex, assigning each surface vertex an index
+  // the first time it is seen. Facets are oriented such that their normals
+  // point along increasing field values: the dual Voronoi edge of a restricted
+  // facet crosses the level set, so the field sign at the circumcenter of an
+  // incident cell tells us on which side of the facet the level set interior
+  // lies.
+  void extractIndexedMesh(const SamplingFunction& fieldSamplingFunction,
+                          const InternalRepresentation& rep,
+                          IndexedTriangleMesh& mesh) {
+    const Triangulation& triangulation = rep.triangulation();
+    mesh.clear();
+    mesh.reserve(rep.number_of_vertices(), rep.number_of_facets());
+
+    std::unordered_map<const void*, IndexedTriangleMesh::IndexType>
+        vertexIndices;
+    vertexIndices.reserve(rep.number_of_vertices());
+    auto indexOf = [&mesh, &vertexIndices](Cell_handle cell, int vertex) {
+      const TrianglePoint& point = cell->vertex(vertex)->point();
+      auto inserted = vertexIndices.emplace(&*cell->vertex(vertex), 0);
+      if (inserted.second) {
+        inserted.first->second =
+            mesh.addVertex(point.x(), point.y(), point.z());
+      }
+      return inserted.first->second;
+    };
+
+    for (auto facetIter = rep.facets_begin(); facetIter != rep.facets_end();
+         ++facetIter) {
+      Facet facet = *facetIter;
+      if (triangulation.is_infinite(facet.first)) {
+        facet = triangulation.mirror_facet(facet);
+      }
+      const Cell_handle& cell = facet.first;
+      const int opposite = facet.second;
+
+      const int v0 = (opposite + 1) & 3;
+      int v1 = (opposite + 2) & 3;
+      int v2 = (opposite + 3) & 3;
+
+      const TrianglePoint& p0 = cell->vertex(v0)->point();
+      Kernel::Vector_3 normal =
+          CGAL::cross_product(cell->vertex(v1)->point() - p0,
+                              cell->vertex(v2)->point() - p0);
+      // Flip the winding if the normal points towards the level set interior.
+      bool pointsIntoCell =
+          normal * (cell->vertex(opposite)->point() - p0) > 0;
+      const TrianglePoint& center = cell->circumcenter();
+      bool cellInside =
+          fieldSamplingFunction(Kernel::Point_3(center.x(), center.y(),
+                                                center.z())) < 0;
+      if (pointsIntoCell == cellInside) {
+        std::swap(v1, v2);
+      }
+
+      mesh.addTriangle(indexOf(cell, v0), indexOf(cell, v1),
+                       indexOf(cell, v2));
     }
 
-    CGAL::output_surface_facets_to_polyhedron(rep, polyhedron);
+    LOG(INFO) << "Extracted indexed level set mesh with "
+              << mesh.numVertices() << " vertices and " << mesh.numTriangles()
+              << " triangles";
   }
+
+  PlyMeshWriter m_meshWriter;
 };
 
 #endif  //_LEVEL_SET_MESH_BUILDER_H_
@@ -21,11 +21,12 @@
 #include <defaultBufferProviders.h>
 #include <uniformPlanarGrid.h>
 #include <uniformVoxelGrid.h>
-#include <uniformVoxelGridGeometryProvider.h>
+#include <voxelMesher.h>
 #include <geometryRenderable.h>
 #include <geometryMesh.h>
 #include <prefabs.h>
 #include <geometryBackedSelectableObject.h>
+#include <voxelGridSelectableObject.h>
 
 #include "separableGeometryInducedField.h"
 #include "distanceFieldComputers.h"
@@ -38,6 +39,12 @@
 DEFINE_bool(write_generated_level_set_mesh, false,
             "Should the mesh created by the level set mesh builder be written "
             "out to file?");
+DEFINE_string(generated_level_set_mesh_path, "mesh.ply",
+              "Path of the binary PLY file the generated level set mesh is "
+              "written to. A .gz suffix compresses the output.");
+DEFINE_bool(show_voxel_grid, false,
+            "Should a fully occupied voxel grid be meshed and shown, with its "
+            "voxels selectable?");
 
 bool initScene(WindowedRenderingApp& app, const std::string& sceneName) {
   std::string windowName = app.getWindowName();
@@ -64,6 +71,7 @@ bool initScene(WindowedRenderingApp& app, const std::string& sceneName) {
 
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
 
   WindowedRenderingApp app("Smoothing");
 
@@ -107,18 +115,22 @@ int main(int argc, char* argv[]) {
     axesNode->setScale(1, 1, 1);
 
 
-    /*UniformVoxelGrid voxelGrid(30.0, 5);
-    using VoxelGeometryProvider =
-        UniformVoxelGridGeometryProvider<VoxelGridCubeProvider>;
-    PositionRenderable<VoxelGeometryProvider>* renderableVoxelGrid =
-        new PositionRenderable<VoxelGeometryProvider>();
-    VoxelGeometryProvider voxelGeometryProvider(voxelGrid);
-    renderableVoxelGrid->setVertexData(
-        PositionOnlyBufferProvider<VoxelGeometryProvider>(
-            voxelGeometryProvider));
-
-    sceneManager->getRootSceneNode()->createChildSceneNode()->attachObject(
-        renderableVoxelGrid);*/
+    // The voxel grid and its occupancy are kept for the lifetime of the
+    // scene, for picking voxels.
+    std::unique_ptr<UniformVoxelGrid> voxelGrid;
+    std::unique_ptr<VoxelMesher::Occupancy> occupancy;
+    if (FLAGS_show_voxel_grid) {
+      voxelGrid.reset(new UniformVoxelGrid(30.0, 5));
+      occupancy.reset(new VoxelMesher::Occupancy(*voxelGrid, 1));
+      IndexedTriangleMesh voxelMesh;
+      VoxelMesher(*voxelGrid).build(*occupancy, voxelMesh, true);
+      Ogre::Entity* voxelEntity =
+          Framework::AppContext::getDynamicMeshManager().addMesh(
+              voxelMesh,
+              sceneManager->getRootSceneNode()->createChildSceneNode());
+      Framework::AppContext::getSelectionManager().addSelectableObject(
+          new VoxelGridSelectableObject(voxelEntity, *voxelGrid, *occupancy));
+    }
 
     app.startEventLoop();
   }
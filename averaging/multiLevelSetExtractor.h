@@ -0,0 +1,242 @@
+#ifndef _MULTI_LEVEL_SET_EXTRACTOR_H_
+#define _MULTI_LEVEL_SET_EXTRACTOR_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "geometryTypes.h"
+#include "indexedTriangleMesh.h"
+
+// Cell corner c is offset from the cell's lowest node by bit 0 of c along x,
+// bit 1 along y and bit 2 along z. Each tetrahedron walks from corner 0 to
+// corner 7 one axis at a time, so for any two of its corners, one is a bitwise
+// subset of the other.
+constexpr int KUHN_TETRAHEDRA[6][4] = {{0, 1, 3, 7}, {0, 1, 5, 7},
+                                       {0, 2, 3, 7}, {0, 2, 6, 7},
+                                       {0, 4, 5, 7}, {0, 4, 6, 7}};
+
+// Extracts a number of level sets of a scalar field at once. The field is
+// sampled once on a regular grid of nodes spanning the bounds. Each grid cell
+// is split into 6 tetrahedra (Kuhn triangulation, which is consistent across
+// neighbouring cells), and each tetrahedron is polygonized at every requested
+// level it straddles -- marching tetrahedra. All the levels are extracted in a
+// single sweep over the cells, so the samples, the per cell range tests and
+// the cell geometry are shared among levels.
+//
+// A vertex is created once per crossed grid edge and level, and shared
+// between all triangles that touch the edge. Triangles are oriented such that
+// their normals point along increasing field values.
+class MultiLevelSetExtractor {
+ public:
+  using IndexType = IndexedTriangleMesh::IndexType;
+
+  // resolution is the number of cells along each axis of the bounds.
+  MultiLevelSetExtractor(const Kernel::Iso_cuboid_3& bounds, size_t resolution)
+      : m_origin{{bounds.xmin(), bounds.ymin(), bounds.zmin()}},
+        m_cellSize{{(bounds.xmax() - bounds.xmin()) / resolution,
+                    (bounds.ymax() - bounds.ymin()) / resolution,
+                    (bounds.zmax() - bounds.zmin()) / resolution}},
+        m_resolution(resolution),
+        m_nodesPerAxis(resolution + 1) {}
+
+  // Samples the field at all grid nodes. The field is queried concurrently,
+  // so its const call operator must be thread safe.
+  template <typename Field>
+  void sampleField(const Field& field) {
+    const long numNodes = m_nodesPerAxis * m_nodesPerAxis * m_nodesPerAxis;
+    m_samples.resize(numNodes);
+#pragma omp parallel for schedule(static)
+    for (long node = 0; node < numNodes; ++node) {
+      size_t i = node % m_nodesPerAxis;
+      size_t j = (node / m_nodesPerAxis) % m_nodesPerAxis;
+      size_t k = node / (m_nodesPerAxis * m_nodesPerAxis);
+      m_samples[node] = field(Kernel::Point_3(nodeCoordinate(0, i),
+                                              nodeCoordinate(1, j),
+                                              nodeCoordinate(2, k)));
+    }
+  }
+
+  bool hasSamples() const { return !m_samples.empty(); }
+
+  // Returns one mesh per isovalue, in the order of the passed in isovalues.
+  // The level set of value L separates samples < L from samples >= L.
+  std::vector<IndexedTriangleMesh> extract(
+      const std::vector<FieldType>& isovalues) const {
+    std::vector<IndexedTriangleMesh> levelSetMeshes(isovalues.size());
+    if (!hasSamples()) {
+      LOG(ERROR) << "Level set extraction requested before sampling a field";
+      return levelSetMeshes;
+    }
+
+    // Work on sorted levels, so that the levels straddled by a cell form a
+    // contiguous range.
+    std::vector<size_t> order(isovalues.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&isovalues](size_t a, size_t b) {
+      return isovalues[a] < isovalues[b];
+    });
+    std::vector<FieldType> levels(isovalues.size());
+    for (size_t level = 0; level < order.size(); ++level) {
+      levels[level] = isovalues[order[level]];
+    }
+
+    std::vector<LevelState> levelStates(levels.size());
+    CellState cell;
+    for (size_t k = 0; k < m_resolution; ++k) {
+      for (size_t j = 0; j < m_resolution; ++j) {
+        for (size_t i = 0; i < m_resolution; ++i) {
+          loadCell(i, j, k, cell);
+          auto minMax = std::minmax_element(cell.values.begin(),
+                                            cell.values.end());
+          auto levelsBegin =
+              std::upper_bound(levels.begin(), levels.end(), *minMax.first);
+          auto levelsEnd =
+              std::upper_bound(levelsBegin, levels.end(), *minMax.second);
+          for (auto levelIter = levelsBegin; levelIter != levelsEnd;
+               ++levelIter) {
+            size_t level = levelIter - levels.begin();
+            polygonizeCell(cell, *levelIter, levelStates[level]);
+          }
+        }
+      }
+    }
+
+    for (size_t level = 0; level < levels.size(); ++level) {
+      levelSetMeshes[order[level]] = std::move(levelStates[level].mesh);
+    }
+    return levelSetMeshes;
+  }
+
+ private:
+  static constexpr int CELL_CORNERS = 8;
+
+  struct CellState {
+    std::array<size_t, CELL_CORNERS> nodes;
+    std::array<FieldType, CELL_CORNERS> values;
+    std::array<Kernel::Point_3, CELL_CORNERS> positions;
+  };
+
+  // Output mesh and crossed edge to vertex map of a single level.
+  struct LevelState {
+    IndexedTriangleMesh mesh;
+    std::unordered_map<std::uint64_t, IndexType> edgeVertices;
+  };
+
+  FieldType nodeCoordinate(int axis, size_t index) const {
+    return m_origin[axis] + index * m_cellSize[axis];
+  }
+
+  size_t nodeIndex(size_t i, size_t j, size_t k) const {
+    return i + m_nodesPerAxis * (j + m_nodesPerAxis * k);
+  }
+
+  void loadCell(size_t i, size_t j, size_t k, CellState& cell) const {
+    for (int corner = 0; corner < CELL_CORNERS; ++corner) {
+      size_t ci = i + (corner & 1);
+      size_t cj = j + ((corner >> 1) & 1);
+      size_t ck = k + ((corner >> 2) & 1);
+      cell.nodes[corner] = nodeIndex(ci, cj, ck);
+      cell.values[corner] = m_samples[cell.nodes[corner]];
+      cell.positions[corner] =
+          Kernel::Point_3(nodeCoordinate(0, ci), nodeCoordinate(1, cj),
+                          nodeCoordinate(2, ck));
+    }
+  }
+
+  // Returns the vertex on the grid edge between cell corners a and b. Edges
+  // are keyed by their lower node and the axis offset to the upper node, so
+  // neighbouring cells agree on the key and on the interpolated position.
+  IndexType edgeVertex(const CellState& cell, int a, int b, FieldType level,
+                       LevelState& state) const {
+    if (a > b) std::swap(a, b);
+    std::uint64_t key =
+        static_cast<std::uint64_t>(cell.nodes[a]) * CELL_CORNERS + (a ^ b);
+    auto inserted = state.edgeVertices.emplace(key, 0);
+    if (inserted.second) {
+      FieldType t =
+          (level - cell.values[a]) / (cell.values[b] - cell.values[a]);
+      Kernel::Point_3 point =
+          cell.positions[a] + t * (cell.positions[b] - cell.positions[a]);
+      inserted.first->second =
+          state.mesh.addVertex(point.x(), point.y(), point.z());
+    }
+    return inserted.first->second;
+  }
+
+  // Adds the triangle, wound such that its normal points along outward.
+  void addTriangle(IndexType v0, IndexType v1, IndexType v2,
+                   const Kernel::Vector_3& outward,
+                   IndexedTriangleMesh& mesh) const {
+    const std::vector<float>& positions = mesh.positions();
+    auto point = [&positions](IndexType v) {
+      return Kernel::Point_3(positions[3 * v], positions[3 * v + 1],
+                             positions[3 * v + 2]);
+    };
+    Kernel::Point_3 p0 = point(v0);
+    Kernel::Vector_3 normal =
+        CGAL::cross_product(point(v1) - p0, point(v2) - p0);
+    if (normal * outward < 0) {
+      mesh.addTriangle(v0, v2, v1);
+    } else {
+      mesh.addTriangle(v0, v1, v2);
+    }
+  }
+
+  void polygonizeCell(const CellState& cell, FieldType level,
+                      LevelState& state) const {
+    for (const auto& tetrahedron : KUHN_TETRAHEDRA) {
+      std::array<int, 4> inside, outside;
+      int numInside = 0, numOutside = 0;
+      Kernel::Vector_3 insideSum = CGAL::NULL_VECTOR;
+      Kernel::Vector_3 outsideSum = CGAL::NULL_VECTOR;
+      for (int corner : tetrahedron) {
+        Kernel::Vector_3 position = cell.positions[corner] - CGAL::ORIGIN;
+        if (cell.values[corner] < level) {
+          inside[numInside++] = corner;
+          insideSum = insideSum + position;
+        } else {
+          outside[numOutside++] = corner;
+          outsideSum = outsideSum + position;
+        }
+      }
+      if (numInside == 0 || numOutside == 0) continue;
+
+      // The level set is planar within the tetrahedron, and separates the
+      // inside corners from the outside ones.
+      Kernel::Vector_3 outward =
+          outsideSum / numOutside - insideSum / numInside;
+
+      if (numInside == 2) {
+        IndexType v0 = edgeVertex(cell, inside[0], outside[0], level, state);
+        IndexType v1 = edgeVertex(cell, inside[0], outside[1], level, state);
+        IndexType v2 = edgeVertex(cell, inside[1], outside[1], level, state);
+        IndexType v3 = edgeVertex(cell, inside[1], outside[0], level, state);
+        addTriangle(v0, v1, v2, outward, state.mesh);
+        addTriangle(v0, v2, v3, outward, state.mesh);
+      } else {
+        // A single corner is separated from the other three.
+        const bool loneInside = numInside == 1;
+        int lone = loneInside ? inside[0] : outside[0];
+        const std::array<int, 4>& others = loneInside ? outside : inside;
+        IndexType v0 = edgeVertex(cell, lone, others[0], level, state);
+        IndexType v1 = edgeVertex(cell, lone, others[1], level, state);
+        IndexType v2 = edgeVertex(cell, lone, others[2], level, state);
+        addTriangle(v0, v1, v2, outward, state.mesh);
+      }
+    }
+  }
+
+  std::array<FieldType, 3> m_origin;
+  std::array<FieldType, 3> m_cellSize;
+  size_t m_resolution;
+  size_t m_nodesPerAxis;
+  std::vector<FieldType> m_samples;
+};
+
+#endif  //_MULTI_LEVEL_SET_EXTRACTOR_H_
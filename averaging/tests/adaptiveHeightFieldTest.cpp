@@ -0,0 +1,104 @@
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "adaptiveHeightField.h"
+
+class AdaptiveHeightFieldTest : public ::testing::Test {
+ protected:
+  // Height field over [-1, 1] x [-1, 1]
+  AdaptiveHeightField makeHeightField() {
+    return AdaptiveHeightField(Kernel::Point_3(-1, -1, 0),
+                               Kernel::Vector_3(2, 0, 0),
+                               Kernel::Vector_3(0, 2, 0), params);
+  }
+
+  static float planarField(const Kernel::Point_2& point) {
+    return 2 * point.x() - point.y();
+  }
+
+  // A narrow bump near (0.5, 0.5)
+  static float bumpField(const Kernel::Point_2& point) {
+    float dx = point.x() - 0.5, dy = point.y() - 0.5;
+    return std::exp(-(dx * dx + dy * dy) / 0.01);
+  }
+
+  // Every edge is shared by two triangles, except those on the domain
+  // boundary. A T-junction would leave interior edges that are used once.
+  static void expectCrackFree(const IndexedTriangleMesh& mesh) {
+    std::map<std::pair<size_t, size_t>, int> edgeUses;
+    const std::vector<IndexedTriangleMesh::IndexType>& indices =
+        mesh.indices();
+    for (size_t t = 0; t < indices.size(); t += VERTICES_PER_TRIANGLE) {
+      for (int e = 0; e < 3; ++e) {
+        size_t a = indices[t + e], b = indices[t + (e + 1) % 3];
+        ++edgeUses[std::make_pair(std::min(a, b), std::max(a, b))];
+      }
+    }
+    const std::vector<float>& positions = mesh.positions();
+    auto onBoundary = [&positions](size_t v) {
+      return std::abs(std::abs(positions[3 * v]) - 1) < 1e-6 ||
+             std::abs(std::abs(positions[3 * v + 1]) - 1) < 1e-6;
+    };
+    for (const auto& edgeUse : edgeUses) {
+      if (edgeUse.second == 1) {
+        EXPECT_TRUE(onBoundary(edgeUse.first.first) &&
+                    onBoundary(edgeUse.first.second));
+      } else {
+        EXPECT_EQ(edgeUse.second, 2);
+      }
+    }
+  }
+
+  AdaptiveHeightFieldParams params;
+};
+
+TEST_F(AdaptiveHeightFieldTest, planarFieldStaysCoarse) {
+  AdaptiveHeightField heightField = makeHeightField();
+  IndexedTriangleMesh mesh;
+  heightField.build(&planarField, mesh);
+
+  size_t tilesPerSide = 1 << params.min_depth;
+  EXPECT_EQ(heightField.numTiles(), tilesPerSide * tilesPerSide);
+  EXPECT_EQ(mesh.numTriangles(), 2 * tilesPerSide * tilesPerSide);
+  EXPECT_EQ(mesh.numVertices(), (tilesPerSide + 1) * (tilesPerSide + 1));
+  EXPECT_FLOAT_EQ(heightField.minHeight(), -3);
+  EXPECT_FLOAT_EQ(heightField.maxHeight(), 3);
+  expectCrackFree(mesh);
+}
+
+TEST_F(AdaptiveHeightFieldTest, refinesNearFeatures) {
+  params.max_depth = 8;
+  AdaptiveHeightField heightField = makeHeightField();
+  IndexedTriangleMesh mesh;
+  heightField.build(&bumpField, mesh);
+
+  size_t uniformSamples = ((1 << params.max_depth) + 1) *
+                          ((1 << params.max_depth) + 1);
+  EXPECT_LT(heightField.numSamples() * 10, uniformSamples);
+  expectCrackFree(mesh);
+
+  // Vertices are sampled heights
+  const std::vector<float>& positions = mesh.positions();
+  for (size_t v = 0; v < mesh.numVertices(); ++v) {
+    EXPECT_FLOAT_EQ(positions[3 * v + 2],
+                    bumpField(Kernel::Point_2(positions[3 * v],
+                                              positions[3 * v + 1])));
+  }
+}
+
+TEST_F(AdaptiveHeightFieldTest, screenSpaceErrorFollowsCamera) {
+  params.max_depth = 8;
+  AdaptiveHeightField heightField = makeHeightField();
+  IndexedTriangleMesh nearMesh, farMesh;
+  heightField.setCamera(Kernel::Point_3(0.5, 0.5, 2), 1000);
+  heightField.build(&bumpField, nearMesh);
+  heightField.setCamera(Kernel::Point_3(0.5, 0.5, 200), 1000);
+  heightField.build(&bumpField, farMesh);
+
+  EXPECT_GT(nearMesh.numTriangles(), farMesh.numTriangles());
+  expectCrackFree(nearMesh);
+  expectCrackFree(farMesh);
+}
@@ -0,0 +1,55 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "indexedTriangleMesh.h"
+#include "levelSetMeshBuilder.h"
+
+class LevelSetMeshBuilderTest : public ::testing::Test {
+ protected:
+  // Unit sphere as the zero level set
+  static Kernel::FT unitSphereField(const Kernel::Point_3& point) {
+    return CGAL::squared_distance(point, CGAL::ORIGIN) - 1;
+  }
+
+  LevelSetMeshBuilder<> meshBuilder;
+  Kernel::Sphere_3 boundingSphere{CGAL::ORIGIN, 4};
+};
+
+TEST_F(LevelSetMeshBuilderTest, indexedMeshSharesVertices) {
+  IndexedTriangleMesh mesh;
+  meshBuilder.buildMesh(&unitSphereField, boundingSphere, 0, mesh);
+
+  ASSERT_FALSE(mesh.empty());
+  // Closed genus 0 surface: V - E + F = 2, with E = 3F / 2
+  EXPECT_EQ(mesh.numVertices(), mesh.numTriangles() / 2 + 2);
+}
+
+TEST_F(LevelSetMeshBuilderTest, indexedMeshContent) {
+  IndexedTriangleMesh mesh;
+  meshBuilder.buildMesh(&unitSphereField, boundingSphere, 0, mesh);
+  ASSERT_FALSE(mesh.empty());
+
+  const std::vector<float>& positions = mesh.positions();
+  auto point = [&positions](IndexedTriangleMesh::IndexType index) {
+    return Kernel::Point_3(positions[3 * index], positions[3 * index + 1],
+                           positions[3 * index + 2]);
+  };
+
+  for (size_t i = 0; i < mesh.numVertices(); ++i) {
+    EXPECT_NEAR(std::sqrt(CGAL::squared_distance(point(i), CGAL::ORIGIN)), 1,
+                1e-2);
+  }
+
+  // All facets are oriented outwards, away from the sphere interior
+  const std::vector<IndexedTriangleMesh::IndexType>& indices = mesh.indices();
+  for (size_t i = 0; i < indices.size(); i += VERTICES_PER_TRIANGLE) {
+    ASSERT_LT(indices[i], mesh.numVertices());
+    ASSERT_LT(indices[i + 1], mesh.numVertices());
+    ASSERT_LT(indices[i + 2], mesh.numVertices());
+    Kernel::Point_3 p0 = point(indices[i]);
+    Kernel::Vector_3 normal = CGAL::cross_product(point(indices[i + 1]) - p0,
+                                                  point(indices[i + 2]) - p0);
+    EXPECT_GT(normal * (p0 - CGAL::ORIGIN), 0);
+  }
+}
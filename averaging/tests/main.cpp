@@ -5,6 +5,9 @@
 DEFINE_bool(write_generated_level_set_mesh, false,
             "Should the generated mesh by the level set mesh builder be "
             "written out to file");
+DEFINE_string(generated_level_set_mesh_path, "mesh.ply",
+              "Path of the binary PLY file the generated level set mesh is "
+              "written to. A .gz suffix compresses the output.");
 
 int main(int argc, char** argv) {
   ::google::InitGoogleLogging(argv[0]);
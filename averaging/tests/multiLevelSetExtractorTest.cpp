@@ -0,0 +1,78 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "multiLevelSetExtractor.h"
+
+class MultiLevelSetExtractorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { extractor.sampleField(&squaredRadius); }
+
+  // Level sets are spheres of radius sqrt(level)
+  static Kernel::FT squaredRadius(const Kernel::Point_3& point) {
+    return CGAL::squared_distance(point, CGAL::ORIGIN);
+  }
+
+  static Kernel::Point_3 vertex(const IndexedTriangleMesh& mesh,
+                                IndexedTriangleMesh::IndexType index) {
+    const std::vector<float>& positions = mesh.positions();
+    return Kernel::Point_3(positions[3 * index], positions[3 * index + 1],
+                           positions[3 * index + 2]);
+  }
+
+  MultiLevelSetExtractor extractor{
+      Kernel::Iso_cuboid_3(Kernel::Point_3(-4, -4, -4),
+                           Kernel::Point_3(4, 4, 4)),
+      32};
+};
+
+TEST_F(MultiLevelSetExtractorTest, matchesSingleLevelExtraction) {
+  std::vector<FieldType> levels{9, 1, 4, 2.5};
+  std::vector<IndexedTriangleMesh> meshes = extractor.extract(levels);
+  ASSERT_EQ(meshes.size(), levels.size());
+
+  for (size_t i = 0; i < levels.size(); ++i) {
+    std::vector<IndexedTriangleMesh> singleMesh =
+        extractor.extract({levels[i]});
+    ASSERT_EQ(singleMesh.size(), 1);
+    EXPECT_FALSE(meshes[i].empty());
+    EXPECT_EQ(meshes[i].positions(), singleMesh[0].positions());
+    EXPECT_EQ(meshes[i].indices(), singleMesh[0].indices());
+  }
+}
+
+TEST_F(MultiLevelSetExtractorTest, nestedSpheres) {
+  std::vector<FieldType> levels{1, 4, 9};
+  std::vector<IndexedTriangleMesh> meshes = extractor.extract(levels);
+
+  for (size_t i = 0; i < levels.size(); ++i) {
+    const IndexedTriangleMesh& mesh = meshes[i];
+    ASSERT_FALSE(mesh.empty());
+    // Closed genus 0 surface: V - E + F = 2, with E = 3F / 2
+    EXPECT_EQ(mesh.numVertices(), mesh.numTriangles() / 2 + 2);
+
+    for (size_t v = 0; v < mesh.numVertices(); ++v) {
+      EXPECT_NEAR(std::sqrt(CGAL::squared_distance(vertex(mesh, v),
+                                                   CGAL::ORIGIN)),
+                  std::sqrt(levels[i]), 0.05);
+    }
+
+    // Normals point along increasing field values, away from the origin
+    const std::vector<IndexedTriangleMesh::IndexType>& indices =
+        mesh.indices();
+    for (size_t t = 0; t < indices.size(); t += VERTICES_PER_TRIANGLE) {
+      Kernel::Point_3 p0 = vertex(mesh, indices[t]);
+      Kernel::Vector_3 normal =
+          CGAL::cross_product(vertex(mesh, indices[t + 1]) - p0,
+                              vertex(mesh, indices[t + 2]) - p0);
+      EXPECT_GE(normal * (p0 - CGAL::ORIGIN), 0);
+    }
+  }
+}
+
+TEST_F(MultiLevelSetExtractorTest, levelsOutsideSampledRange) {
+  std::vector<IndexedTriangleMesh> meshes = extractor.extract({-1, 1000});
+  ASSERT_EQ(meshes.size(), 2);
+  EXPECT_TRUE(meshes[0].empty());
+  EXPECT_TRUE(meshes[1].empty());
+}
@@ -12,7 +12,8 @@ ViewManager::ViewManager(Ogre::SceneManager* sceneManager)
 void ViewManager::init() {
   // Populate common interaction handler
   m_commonInteractionsHandler.reset(new CommonViewInteractionsHandler(
-      m_sceneManager->getRootSceneNode()->createChildSceneNode()));
+      m_sceneManager->getRootSceneNode()->createChildSceneNode(),
+      m_sceneManager->getCamera("PrimaryCamera")));
 
   // Add widgets and setup callbacks
   CEGUI::WindowManager& windowManager = CEGUI::WindowManager::getSingleton();
@@ -28,6 +29,18 @@ void ViewManager::init() {
           CEGUI::Event::Subscriber(
               &CommonViewInteractionsHandler::levelSetSliderChanged,
               m_commonInteractionsHandler.get()));
+  averagingLayout->getChild("NestedLevelSetSlider")
+      ->subscribeEvent(
+          CEGUI::Slider::EventThumbTrackEnded,
+          CEGUI::Event::Subscriber(
+              &CommonViewInteractionsHandler::nestedLevelSetSliderChanged,
+              m_commonInteractionsHandler.get()));
+  averagingLayout->getChild("AdaptiveHeightFieldCheckbox")
+      ->subscribeEvent(
+          CEGUI::ToggleButton::EventSelectStateChanged,
+          CEGUI::Event::Subscriber(
+              &CommonViewInteractionsHandler::adaptiveHeightFieldToggled,
+              m_commonInteractionsHandler.get()));
 
   CEGUI::Window* navigationPane =
       averagingLayout->getChild("NavigationLinkContainer");
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+#include <glog/logging.h>
+
+#include "gcodeWriter.h"
+
+namespace {
+
+// A working plane of G-code arcs: the select code, the axis normal to the
+// plane, and the names of the center offsets along the in plane axes.
+struct ArcPlane {
+  const char* code;
+  int normalAxis;
+  int axes[2];
+  char offsetNames[2];
+};
+
+const ArcPlane ARC_PLANES[] = {{"G17", 2, {0, 1}, {'I', 'J'}},
+                               {"G18", 1, {0, 2}, {'I', 'K'}},
+                               {"G19", 0, {1, 2}, {'J', 'K'}}};
+
+FieldType coordinate(const Kernel::Point_3& point, int axis) {
+  return axis == 0 ? point.x() : axis == 1 ? point.y() : point.z();
+}
+
+FieldType component(const Kernel::Vector_3& vector, int axis) {
+  return axis == 0 ? vector.x() : axis == 1 ? vector.y() : vector.z();
+}
+
+void writePosition(const Kernel::Point_3& point, std::ostream& out) {
+  out << " X" << point.x() << " Y" << point.y() << " Z" << point.z();
+}
+
+}  // end anonymous namespace
+
+void GCodeWriter::write(const Biarc_3& curve, std::ostream& out) const {
+  out << std::fixed << std::setprecision(m_params.precision);
+  out << "G90\n";
+  if (curve.size() == 0) return;
+
+  out << "G00";
+  writePosition(curve.begin()->start, out);
+  out << "\n";
+
+  const double cosPlaneTolerance = std::cos(m_params.plane_angle_tolerance);
+  const ArcPlane* currentPlane = nullptr;
+  bool feedWritten = m_params.feed_rate == 0;
+  auto writeFeed = [&]() {
+    if (feedWritten) return;
+    out << " F" << m_params.feed_rate;
+    feedWritten = true;
+  };
+
+  for (const CurvePrimitive_3& primitive : curve) {
+    const ArcPlane* arcPlane = nullptr;
+    FieldType normalComponent = 0;
+    if (primitive.isArc()) {
+      const FieldType normalLength =
+          std::sqrt(primitive.normal.squared_length());
+      for (const ArcPlane& plane : ARC_PLANES) {
+        normalComponent =
+            component(primitive.normal, plane.normalAxis) / normalLength;
+        if (std::abs(normalComponent) >= cosPlaneTolerance) {
+          arcPlane = &plane;
+          break;
+        }
+      }
+    }
+
+    if (!primitive.isArc() || !arcPlane) {
+      // Lines, and arcs out of the coordinate planes, as chords.
+      const size_t numChords =
+          primitive.numChords(m_params.linearization_tolerance);
+      for (size_t chord = 1; chord <= numChords; ++chord) {
+        out << "G01";
+        writePosition(chord == numChords
+                          ? primitive.end
+                          : primitive.pointAt(FieldType(chord) / numChords),
+                      out);
+        writeFeed();
+        out << "\n";
+      }
+      continue;
+    }
+
+    if (arcPlane != currentPlane) {
+      out << arcPlane->code << "\n";
+      currentPlane = arcPlane;
+    }
+    // Counter clockwise seen from the positive end of the plane normal axis
+    // is G03.
+    const bool counterClockwise =
+        (primitive.sweep > 0) == (normalComponent > 0);
+    out << (counterClockwise ? "G03" : "G02");
+    writePosition(primitive.end, out);
+    for (int axis = 0; axis < 2; ++axis) {
+      const int coordinateAxis = arcPlane->axes[axis];
+      out << " " << arcPlane->offsetNames[axis]
+          << coordinate(primitive.center, coordinateAxis) -
+                 coordinate(primitive.start, coordinateAxis);
+    }
+    writeFeed();
+    out << "\n";
+  }
+}
+
+bool GCodeWriter::write(const Biarc_3& curve,
+                        const std::string& filePath) const {
+  std::ofstream file(filePath);
+  if (!file.good()) {
+    LOG(ERROR) << "Could not open " << filePath << " to write G-code";
+    return false;
+  }
+  write(curve, file);
+  return file.good();
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#ifdef FRAMEWORK_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include <glog/logging.h>
+
+#include "plyMeshWriter.h"
+
+namespace {
+// A minimal byte sink over either a plain, or a gzip compressed file.
+class OutputSink {
+ public:
+  virtual ~OutputSink() {}
+  virtual bool good() const = 0;
+  virtual bool write(const char* data, size_t size) = 0;
+};
+
+class FileSink : public OutputSink {
+ public:
+  FileSink(const std::string& filePath)
+      : m_file(std::fopen(filePath.c_str(), "wb")) {
+    if (m_file) {
+      // We do our own chunking. Skip the stdio buffer.
+      std::setvbuf(m_file, nullptr, _IONBF, 0);
+    }
+  }
+  ~FileSink() {
+    if (m_file) std::fclose(m_file);
+  }
+
+  bool good() const override { return m_file != nullptr; }
+  bool write(const char* data, size_t size) override {
+    return std::fwrite(data, 1, size, m_file) == size;
+  }
+
+ private:
+  std::FILE* m_file;
+};
+
+#ifdef FRAMEWORK_HAS_ZLIB
+class GzipSink : public OutputSink {
+ public:
+  GzipSink(const std::string& filePath)
+      : m_file(gzopen(filePath.c_str(), "wb1")) {
+    if (m_file) gzbuffer(m_file, PlyMeshWriter::CHUNK_SIZE);
+  }
+  ~GzipSink() {
+    if (m_file) gzclose(m_file);
+  }
+
+  bool good() const override { return m_file != nullptr; }
+  bool write(const char* data, size_t size) override {
+    return gzwrite(m_file, data, size) == static_cast<int>(size);
+  }
+
+ private:
+  gzFile m_file;
+};
+#endif
+
+bool endsWith(const std::string& string, const std::string& suffix) {
+  return string.size() >= suffix.size() &&
+         string.compare(string.size() - suffix.size(), suffix.size(),
+                        suffix) == 0;
+}
+
+std::unique_ptr<OutputSink> makeSink(const std::string& filePath) {
+  if (endsWith(filePath, ".gz")) {
+#ifdef FRAMEWORK_HAS_ZLIB
+    return std::unique_ptr<OutputSink>(new GzipSink(filePath));
+#else
+    LOG(WARNING) << "Built without zlib. Writing " << filePath
+                 << " uncompressed";
+#endif
+  }
+  return std::unique_ptr<OutputSink>(new FileSink(filePath));
+}
+
+bool isLittleEndian() {
+  const std::uint16_t probe = 1;
+  return *reinterpret_cast<const std::uint8_t*>(&probe) == 1;
+}
+
+// Batches writes into CHUNK_SIZE blocks before handing them to the sink.
+class ChunkedWriter {
+ public:
+  ChunkedWriter(OutputSink& sink) : m_sink(sink), m_good(true) {
+    m_buffer.reserve(PlyMeshWriter::CHUNK_SIZE);
+  }
+
+  void append(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+      size_t toCopy =
+          std::min(size, PlyMeshWriter::CHUNK_SIZE - m_buffer.size());
+      m_buffer.insert(m_buffer.end(), bytes, bytes + toCopy);
+      bytes += toCopy;
+      size -= toCopy;
+      if (m_buffer.size() == PlyMeshWriter::CHUNK_SIZE) flush();
+    }
+  }
+
+  bool flush() {
+    if (!m_buffer.empty()) {
+      m_good = m_good && m_sink.write(m_buffer.data(), m_buffer.size());
+      m_buffer.clear();
+    }
+    return m_good;
+  }
+
+ private:
+  OutputSink& m_sink;
+  std::vector<char> m_buffer;
+  bool m_good;
+};
+}  // end anonymous namespace
+
+PlyMeshWriter::PlyMeshWriter() : m_lastWriteSucceeded(true) {}
+
+PlyMeshWriter::~PlyMeshWriter() { wait(); }
+
+void PlyMeshWriter::writeAsync(IndexedTriangleMesh mesh,
+                               const std::string& filePath) {
+  wait();
+  m_writerThread =
+      std::thread([ this, mesh = std::move(mesh), filePath ]() {
+        m_lastWriteSucceeded = write(mesh, filePath);
+      });
+}
+
+bool PlyMeshWriter::wait() {
+  if (m_writerThread.joinable()) {
+    m_writerThread.join();
+  }
+  return m_lastWriteSucceeded;
+}
+
+bool PlyMeshWriter::write(const IndexedTriangleMesh& mesh,
+                          const std::string& filePath) {
+  std::unique_ptr<OutputSink> sink = makeSink(filePath);
+  if (!sink->good()) {
+    LOG(ERROR) << "File handle not accesible for writing mesh to "
+               << filePath;
+    return false;
+  }
+
+  // Data is written in the host byte order, and the header says so.
+  std::ostringstream header;
+  header << "ply\n"
+         << "format "
+         << (isLittleEndian() ? "binary_little_endian" : "binary_big_endian")
+         << " 1.0\n"
+         << "element vertex " << mesh.numVertices() << "\n"
+         << "property float x\n"
+         << "property float y\n"
+         << "property float z\n"
+         << "element face " << mesh.numTriangles() << "\n"
+         << "property list uchar uint vertex_indices\n"
+         << "end_header\n";
+
+  ChunkedWriter writer(*sink);
+  const std::string headerString = header.str();
+  writer.append(headerString.data(), headerString.size());
+
+  // The vertex block is the position buffer as is.
+  writer.append(mesh.positions().data(),
+                mesh.positions().size() * sizeof(float));
+
+  // Each face is prefixed by its vertex count.
+  constexpr size_t INDICES_SIZE =
+      VERTICES_PER_TRIANGLE * sizeof(IndexedTriangleMesh::IndexType);
+  char face[1 + INDICES_SIZE];
+  face[0] = static_cast<char>(VERTICES_PER_TRIANGLE);
+  const std::vector<IndexedTriangleMesh::IndexType>& indices = mesh.indices();
+  for (size_t i = 0; i < indices.size(); i += VERTICES_PER_TRIANGLE) {
+    std::memcpy(face + 1, &indices[i], INDICES_SIZE);
+    writer.append(face, sizeof(face));
+  }
+
+  if (!writer.flush()) {
+    LOG(ERROR) << "Failed writing mesh to " << filePath;
+    return false;
+  }
+  LOG(INFO) << "Wrote mesh with " << mesh.numVertices() << " vertices and "
+            << mesh.numTriangles() << " faces to " << filePath;
+  return true;
+}
@@ -65,8 +65,9 @@ bool buildPolylineFromObj<Kernel::Point_3>(
 // consisting of delimited coordinates of a vertex. The polyline is assumed to
 // be the line created by connecting consecutive vertices in the file.
 template <>
-bool buildPolylineFromVertexList(const std::string& filePath,
-                                 Polyline<Kernel::Point_3>& polyline) {
+bool readVertexList<Kernel::Point_3>(
+    const std::string& filePath,
+    const std::function<void(const Kernel::Point_3&)>& onVertex) {
   std::ifstream file(filePath);
 
   if (!file.good()) {
@@ -90,8 +91,15 @@ bool buildPolylineFromVertexList(const std::string& filePath,
       }
       pointCoords[index++] = std::stod(coord);
     }
-    polyline.addPoint(
-        Kernel::Point_3(pointCoords[0], pointCoords[1], pointCoords[2]));
+    onVertex(Kernel::Point_3(pointCoords[0], pointCoords[1], pointCoords[2]));
   }
   return true;
 }
+
+template <>
+bool buildPolylineFromVertexList(const std::string& filePath,
+                                 Polyline<Kernel::Point_3>& polyline) {
+  return readVertexList<Kernel::Point_3>(
+      filePath,
+      [&polyline](const Kernel::Point_3& point) { polyline.addPoint(point); });
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <psimpl.h>
+
+#include "simplification/polyline_3DouglasPeuckerRanking.h"
+
+using Polyline_3 = Polyline<Kernel::Point_3>;
+
+namespace {
+
+// A sub polyline [first, last] of point indexes, and the smallest squared
+// distance of the keys the recursion went through to get to it.
+struct SubPolyline {
+  size_t first;
+  size_t last;
+  FieldType bound2;
+};
+
+}  // end anonymous namespace
+
+Polyline_3DouglasPeuckerRanking::Polyline_3DouglasPeuckerRanking(
+    const Polyline_3& polyline)
+    : m_polyline(polyline),
+      m_importances(polyline.size(),
+                    std::numeric_limits<FieldType>::infinity()) {
+  const size_t numPoints = m_polyline.size();
+  if (numPoints < 3) return;
+
+  std::vector<FieldType> coords;
+  coords.reserve(3 * numPoints);
+  for (const Kernel::Point_3& point : m_polyline) {
+    coords.push_back(point.x());
+    coords.push_back(point.y());
+    coords.push_back(point.z());
+  }
+  const FieldType* flat = coords.data();
+
+  // Squared importances, square rooted once all are known.
+  std::vector<SubPolyline> stack;
+  stack.push_back({0, numPoints - 1, std::numeric_limits<FieldType>::max()});
+  while (!stack.empty()) {
+    const SubPolyline sub = stack.back();
+    stack.pop_back();
+    if (sub.last - sub.first < 2) continue;
+
+    // Ties are broken as in psimpl, by the last point.
+    const FieldType* first = flat + 3 * sub.first;
+    const FieldType* last = flat + 3 * sub.last;
+    size_t key = sub.first + 1;
+    FieldType keyDist2 = 0;
+    for (size_t point = sub.first + 1; point < sub.last; ++point) {
+      FieldType d2 =
+          psimpl::math::segment_distance2<3>(first, last, flat + 3 * point);
+      if (d2 < keyDist2) continue;
+      key = point;
+      keyDist2 = d2;
+    }
+
+    const FieldType bound2 = std::min(keyDist2, sub.bound2);
+    m_importances[key] = bound2;
+    stack.push_back({sub.first, key, bound2});
+    stack.push_back({key, sub.last, bound2});
+  }
+
+  for (size_t point = 1; point + 1 < numPoints; ++point) {
+    m_importances[point] = std::sqrt(m_importances[point]);
+  }
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3DouglasPeuckerRanking::simplify(
+    FieldType tolerance) const {
+  Polyline_3 simplified;
+  auto importance = m_importances.begin();
+  for (const Kernel::Point_3& point : m_polyline) {
+    if (*importance++ > tolerance) simplified.addPoint(point);
+  }
+  return std::make_tuple(simplified.size(), simplified);
+}
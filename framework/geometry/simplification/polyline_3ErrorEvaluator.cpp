@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include "simplification/polyline_3ErrorEvaluator.h"
+
+using Polyline_3 = Polyline<Kernel::Point_3>;
+
+namespace {
+
+// Bounding volume hierarchy over the segments of a polyline. Consecutive
+// segments are spatially coherent, so splitting the segment range in halves
+// gives tight boxes, and the tree is stored implicitly: node n covers a
+// contiguous range of segments, with children 2n + 1 and 2n + 2.
+class SegmentHierarchy {
+ public:
+  explicit SegmentHierarchy(const Polyline_3& polyline) {
+    m_points.reserve(polyline.size());
+    for (const Kernel::Point_3& point : polyline) {
+      m_points.emplace_back(point.x(), point.y(), point.z());
+    }
+    const size_t numSegments = m_points.size() > 1 ? m_points.size() - 1 : 0;
+    if (numSegments == 0) return;
+
+    size_t numLeaves = 1;
+    while (numLeaves * LEAF_SEGMENTS < numSegments) numLeaves *= 2;
+    m_nodes.resize(2 * numLeaves - 1);
+    build(0, 0, numSegments);
+  }
+
+  // Squared distance from point to the polyline. A polyline of a single point
+  // is that point.
+  double squaredDistance(const Eigen::Vector3d& point) const {
+    if (m_nodes.empty()) {
+      return m_points.empty() ? std::numeric_limits<double>::infinity()
+                              : (point - m_points.front()).squaredNorm();
+    }
+
+    // Depth first, with at most one pending sibling per level.
+    std::array<size_t, 2 * MAX_DEPTH> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    double best = std::numeric_limits<double>::infinity();
+    while (stackSize != 0) {
+      const size_t nodeIndex = stack[--stackSize];
+      const Node& node = m_nodes[nodeIndex];
+      if (node.box.squaredExteriorDistance(point) >= best) continue;
+
+      if (isLeaf(nodeIndex)) {
+        for (size_t segment = node.begin; segment < node.end; ++segment) {
+          best = std::min(best, segmentSquaredDistance(point, segment));
+        }
+        continue;
+      }
+      // Visit the nearer child first, for an earlier, tighter bound.
+      size_t nearChild = 2 * nodeIndex + 1, farChild = nearChild + 1;
+      if (m_nodes[farChild].box.squaredExteriorDistance(point) <
+          m_nodes[nearChild].box.squaredExteriorDistance(point)) {
+        std::swap(nearChild, farChild);
+      }
+      stack[stackSize++] = farChild;
+      stack[stackSize++] = nearChild;
+    }
+    return best;
+  }
+
+ private:
+  static constexpr size_t LEAF_SEGMENTS = 8;
+  static constexpr size_t MAX_DEPTH = 64;
+
+  struct Node {
+    Eigen::AlignedBox3d box;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  void build(size_t nodeIndex, size_t begin, size_t end) {
+    Node& node = m_nodes[nodeIndex];
+    node.begin = begin;
+    node.end = end;
+    for (size_t point = begin; point <= end && begin < end; ++point) {
+      node.box.extend(m_points[point]);
+    }
+    if (isLeaf(nodeIndex)) return;
+    const size_t middle = begin + (end - begin) / 2;
+    build(2 * nodeIndex + 1, begin, middle);
+    build(2 * nodeIndex + 2, middle, end);
+  }
+
+  bool isLeaf(size_t nodeIndex) const {
+    return 2 * nodeIndex + 1 >= m_nodes.size();
+  }
+
+  double segmentSquaredDistance(const Eigen::Vector3d& point,
+                                size_t segment) const {
+    const Eigen::Vector3d& source = m_points[segment];
+    const Eigen::Vector3d direction = m_points[segment + 1] - source;
+    const double length2 = direction.squaredNorm();
+    double t = length2 > 0 ? (point - source).dot(direction) / length2 : 0;
+    t = std::min(1.0, std::max(0.0, t));
+    return (source + t * direction - point).squaredNorm();
+  }
+
+  std::vector<Eigen::Vector3d> m_points;
+  std::vector<Node> m_nodes;
+};
+
+constexpr size_t SegmentHierarchy::LEAF_SEGMENTS;
+constexpr size_t SegmentHierarchy::MAX_DEPTH;
+
+struct DirectedDeviation {
+  double maxDistance = 0;
+  double meanDistance = 0;
+  size_t numSamples = 0;
+};
+
+// Deviation of from to the polyline in target, sampling each segment of from
+// at most spacing apart. The mean is weighted by segment length.
+DirectedDeviation directedDeviation(const Polyline_3& from,
+                                    const SegmentHierarchy& target,
+                                    double spacing) {
+  std::vector<Eigen::Vector3d> points;
+  points.reserve(from.size());
+  for (const Kernel::Point_3& point : from) {
+    points.emplace_back(point.x(), point.y(), point.z());
+  }
+
+  DirectedDeviation deviation;
+  if (points.empty()) return deviation;
+
+  double maxSquaredDistance = target.squaredDistance(points.back());
+  double weightedSum = 0, totalLength = 0;
+  size_t numSamples = 1;
+  const long numSegments = long(points.size()) - 1;
+#pragma omp parallel for schedule(dynamic, 64) \
+    reduction(max : maxSquaredDistance) \
+    reduction(+ : weightedSum, totalLength, numSamples)
+  for (long segment = 0; segment < numSegments; ++segment) {
+    const Eigen::Vector3d& source = points[segment];
+    const Eigen::Vector3d direction = points[segment + 1] - source;
+    const double length = direction.norm();
+    const size_t numSteps =
+        std::max<size_t>(1, std::ceil(length / std::max(spacing, 1e-12)));
+    // Samples at the start of each of the numSteps sub segments. The end of
+    // the segment is sampled as the start of the next one.
+    double segmentSum = 0;
+    for (size_t step = 0; step < numSteps; ++step) {
+      const double squaredDistance =
+          target.squaredDistance(source + (double(step) / numSteps) * direction);
+      maxSquaredDistance = std::max(maxSquaredDistance, squaredDistance);
+      segmentSum += std::sqrt(squaredDistance);
+    }
+    weightedSum += segmentSum / numSteps * length;
+    totalLength += length;
+    numSamples += numSteps;
+  }
+
+  deviation.maxDistance = std::sqrt(maxSquaredDistance);
+  deviation.meanDistance =
+      totalLength > 0 ? weightedSum / totalLength : deviation.maxDistance;
+  deviation.numSamples = numSamples;
+  return deviation;
+}
+
+}  // end anonymous namespace
+
+Polyline_3Deviation Polyline_3ErrorEvaluator::evaluate(
+    const Polyline_3& original, const Polyline_3& simplified) const {
+  Polyline_3Deviation deviation;
+  if (original.size() == 0 || simplified.size() == 0) return deviation;
+
+  const SegmentHierarchy originalHierarchy(original);
+  const SegmentHierarchy simplifiedHierarchy(simplified);
+  DirectedDeviation forward =
+      directedDeviation(original, simplifiedHierarchy, m_sampleSpacing);
+  DirectedDeviation backward =
+      directedDeviation(simplified, originalHierarchy, m_sampleSpacing);
+
+  deviation.maxOriginalToSimplified = forward.maxDistance;
+  deviation.maxSimplifiedToOriginal = backward.maxDistance;
+  deviation.hausdorff = std::max(forward.maxDistance, backward.maxDistance);
+  deviation.meanDeviation = forward.meanDistance;
+  deviation.numSamples = forward.numSamples + backward.numSamples;
+  return deviation;
+}
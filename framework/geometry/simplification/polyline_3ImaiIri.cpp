@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "geometryTypes.h"
+#include "polyline.h"
+#include "simplification/polyline_3Simplifier.h"
+
+using Polyline_3 = Polyline<Kernel::Point_3>;
+
+namespace {
+
+// Slack on the cone comparisons, so that round off neither drops a cone that
+// is not quite contained in another, nor declares touching cones disjoint.
+constexpr double COS_EPSILON = 1e-12;
+
+// The set of directions of rays from a fixed origin that pass within
+// tolerance of all points added so far. A point at distance d > tolerance
+// from the origin restricts the directions to a circular cone about the
+// direction to the point, of half angle asin(tolerance / d). Points within
+// tolerance of the origin do not restrict the directions.
+//
+// The intersection of the cones is represented by the cones themselves, with
+// cones that contain another one dropped, as they do not restrict the
+// intersection any further. Along a smooth curve, far points give narrow
+// cones nested within the wider cones of closer points, and so, few cones
+// remain. Angles are compared through their cosines, with no trigonometric
+// function evaluation.
+class ConeIntersection {
+ public:
+  explicit ConeIntersection(double tolerance)
+      : m_tolerance(tolerance), m_empty(false) {}
+
+  void addPoint(const Eigen::Vector3d& offset) {
+    const double distance = offset.norm();
+    if (distance <= m_tolerance) return;
+    const double sinHalfAngle = m_tolerance / distance;
+    const Cone cone{offset / distance, sinHalfAngle,
+                    std::sqrt(1 - sinHalfAngle * sinHalfAngle)};
+
+    for (const Cone& other : m_cones) {
+      const double cosAngle = cone.axis.dot(other.axis);
+      if (contains(cone, other, cosAngle)) return;
+      // Two disjoint cones is the one emptiness test done, and it suffices to
+      // stop the search once the curve turns away.
+      if (cosAngle < cone.cosHalfAngle * other.cosHalfAngle -
+                         cone.sinHalfAngle * other.sinHalfAngle -
+                         COS_EPSILON) {
+        m_empty = true;
+      }
+    }
+    m_cones.erase(std::remove_if(m_cones.begin(), m_cones.end(),
+                                 [&cone](const Cone& other) {
+                                   return contains(other, cone,
+                                                   cone.axis.dot(other.axis));
+                                 }),
+                  m_cones.end());
+    m_cones.push_back(cone);
+  }
+
+  // Whether the ray from the origin along the direction (of unit length)
+  // passes within tolerance of all points added so far
+  bool contains(const Eigen::Vector3d& direction) const {
+    for (const Cone& cone : m_cones) {
+      if (direction.dot(cone.axis) < cone.cosHalfAngle) return false;
+    }
+    return true;
+  }
+
+  // No point restricts the directions: all are within tolerance of the origin
+  bool unrestricted() const { return m_cones.empty(); }
+
+  // When true, no direction is within the intersection. The converse need not
+  // hold.
+  bool empty() const { return m_empty; }
+
+ private:
+  struct Cone {
+    Eigen::Vector3d axis;
+    double sinHalfAngle;
+    double cosHalfAngle;
+  };
+
+  // Whether outer contains inner, given the cosine of the angle between their
+  // axes: the angle is at most the difference of the half angles.
+  static bool contains(const Cone& outer, const Cone& inner, double cosAngle) {
+    return outer.sinHalfAngle >= inner.sinHalfAngle &&
+           cosAngle >= outer.cosHalfAngle * inner.cosHalfAngle +
+                           outer.sinHalfAngle * inner.sinHalfAngle +
+                           COS_EPSILON;
+  }
+
+  double m_tolerance;
+  bool m_empty;
+  std::vector<Cone> m_cones;
+};
+
+// The ends reachable from points[start] by a shortcut whose ray from
+// points[start] passes within tolerance of all the points it skips. Ends are
+// enumerated in the order of step, which is +1 or -1.
+std::vector<size_t> rayReachable(const std::vector<Eigen::Vector3d>& points,
+                                 size_t start, int step, double tolerance) {
+  std::vector<size_t> ends;
+  ConeIntersection cones(tolerance);
+  const long numPoints = points.size();
+  for (long end = long(start) + step; end >= 0 && end < numPoints;
+       end += step) {
+    const Eigen::Vector3d offset = points[end] - points[start];
+    const double length = offset.norm();
+    const bool reachable = length > 0 ? cones.contains(offset / length)
+                                      : cones.unrestricted();
+    if (reachable) ends.push_back(end);
+    cones.addPoint(offset);
+    if (cones.empty()) break;
+  }
+  return ends;
+}
+
+}  // end anonymous namespace
+
+// Imai-Iri: the shortcut (i, j) is valid when all points between i and j are
+// within tolerance of the segment from point i to point j, and the simplified
+// polyline is the path with fewest shortcuts from the first point to the last.
+//
+// A point is within tolerance of the segment exactly when it is within
+// tolerance of the ray from i through j, and of the ray from j through i.
+// The first is tested for all j of a given i incrementally, by the cone
+// intersection of the points seen from i so far, and the second likewise,
+// going backwards from j. Both passes are parallel over their start points.
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyImaiIri& /**/) {
+  const size_t numPoints = input.size();
+  if (numPoints < 3) {
+    return std::make_tuple(numPoints, input);
+  }
+
+  std::vector<Eigen::Vector3d> points;
+  points.reserve(numPoints);
+  for (const Kernel::Point_3& point : input) {
+    points.emplace_back(point.x(), point.y(), point.z());
+  }
+
+  const double tolerance = m_tolerance;
+  std::vector<std::vector<size_t>> forward(numPoints);
+  std::vector<std::vector<size_t>> backward(numPoints);
+#pragma omp parallel for schedule(dynamic, 16)
+  for (long point = 0; point < long(numPoints); ++point) {
+    forward[point] = rayReachable(points, point, 1, tolerance);
+    backward[point] = rayReachable(points, point, -1, tolerance);
+    std::reverse(backward[point].begin(), backward[point].end());
+  }
+
+  // Shortest path over the valid shortcuts, which all go forward.
+  const size_t unreached = std::numeric_limits<size_t>::max();
+  std::vector<size_t> hops(numPoints, unreached);
+  std::vector<size_t> previous(numPoints, 0);
+  hops[0] = 0;
+  for (size_t start = 0; start < numPoints; ++start) {
+    if (hops[start] == unreached) continue;
+    for (size_t end : forward[start]) {
+      if (hops[start] + 1 < hops[end] &&
+          std::binary_search(backward[end].begin(), backward[end].end(),
+                             start)) {
+        hops[end] = hops[start] + 1;
+        previous[end] = start;
+      }
+    }
+  }
+
+  std::vector<size_t> path;
+  for (size_t point = numPoints - 1; point != 0; point = previous[point]) {
+    path.push_back(point);
+  }
+  path.push_back(0);
+
+  Polyline_3 simplified;
+  simplified.reserve(path.size());
+  for (auto index = path.rbegin(); index != path.rend(); ++index) {
+    simplified.addPoint(*(input.begin() + *index));
+  }
+  return std::make_tuple(simplified.size(), simplified);
+}
@@ -0,0 +1,62 @@
+#include <psimpl.h>
+
+#include "geometryTypes.h"
+#include "polyline.h"
+#include "simplification/polyline_3Simplifier.h"
+#include "simplification/psimplAdapters.h"
+
+// The linear time psimpl routines. All of them keep a subset of the input
+// points, and read the coordinates in full precision.
+
+using Polyline_3 = Polyline<Kernel::Point_3>;
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyRadialDistance& /**/) {
+  Polyline_3 simplified = prefilterRadialDistance(input, m_tolerance);
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyReumannWitkam& /**/) {
+  const FieldType tolerance = m_tolerance;
+  Polyline_3 simplified = simplifyWithPsimpl(
+      input, [tolerance](auto first, auto last, auto result) {
+        psimpl::simplify_reumann_witkam<3>(first, last, tolerance, result);
+      });
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyOpheim& strategy) {
+  const FieldType tolerance = m_tolerance;
+  const FieldType searchDistance = strategy.m_searchDistanceFactor * tolerance;
+  Polyline_3 simplified = simplifyWithPsimpl(
+      input, [tolerance, searchDistance](auto first, auto last, auto result) {
+        psimpl::simplify_opheim<3>(first, last, tolerance, searchDistance,
+                                   result);
+      });
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyLang& strategy) {
+  const FieldType tolerance = m_tolerance;
+  const unsigned lookAhead = strategy.m_lookAhead;
+  Polyline_3 simplified = simplifyWithPsimpl(
+      input, [tolerance, lookAhead](auto first, auto last, auto result) {
+        psimpl::simplify_lang<3>(first, last, tolerance, lookAhead, result);
+      });
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+Polyline_3 Polyline_3Simplifier::prefilterRadialDistance(
+    const Polyline_3& input, FieldType tolerance) {
+  return simplifyWithPsimpl(
+      input, [tolerance](auto first, auto last, auto result) {
+        psimpl::simplify_radial_distance<3>(first, last, tolerance, result);
+      });
+}
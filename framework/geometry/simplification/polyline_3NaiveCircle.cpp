@@ -1,207 +1,159 @@
 #include <math.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include <glog/logging.h>
 
 #include <Eigen/Dense>
 
 #include <containerAlgorithms.h>
 
+#include "biarc_3.h"
 #include "geometryConstants.h"
 #include "geometryTypes.h"
 #include "polyline.h"
+#include "simplification/circleFit.h"
 #include "simplification/polyline_3Simplifier.h"
 
 using Polyline_3 = Polyline<Kernel::Point_3>;
 
-// Check if the set of family of planes that share the line through being and
-// end and have the distance between all points between being and end less than
-// the prescribed tolerance is non-empty? Is so, the result is a tuple of bool,
-// and two planes that bound the wedge.
-using FindWedgeResult = std::tuple<bool, Kernel::Plane_3, Kernel::Plane_3>;
-template <typename PointIter>
-FindWedgeResult findWedgeForTolerance(PointIter begin, PointIter end,
-                                      Kernel::FT tolerance) {
-  assert(begin != end);
-  DLOG_IF(ERROR, *begin == *end)
-      << "FindWedgeForTolerance - fed in iterators where the first and last "
-         "dereferenced points are the same. This could actually represent an "
-         "entire circle, instead of a degenerate case of all points being "
-         "coincident and has to be properly handled. Now would be a good time "
-         "to write code that handles this case.";
+namespace circle_fit {
 
-  bool wedgeFound = false;
-  Kernel::Line_3 wedgePivotLine(*begin, *end);
-  Kernel::Plane_3 referencePlane = wedgePivotLine.perpendicular_plane(*begin);
-  Kernel::Plane_3 wedgePlane1 = referencePlane;
-  Kernel::Plane_3 wedgePlane2 = referencePlane;
+WedgeTracker::WedgeTracker(const Kernel::Point_3& begin, Kernel::FT tolerance)
+    : m_begin(toEigen(begin)),
+      m_beginPoint(begin),
+      m_tolerance(tolerance),
+      m_numPoints(0) {}
 
-  // Must be that all points are colinear. Returning two same planes to
-  // indicate that the wedge includes all planes.
-  if (referencePlane.is_degenerate()) {
-    return std::make_tuple(true, wedgePlane1, wedgePlane2);
+void WedgeTracker::addPoint(const Kernel::Point_3& point) {
+  Eigen::Vector3d offset = toEigen(point) - m_begin;
+  if (offset.squaredNorm() > m_tolerance * m_tolerance) {
+    m_constraints.push_back(Constraint{m_numPoints, offset});
   }
-  Kernel::Vector_3 normedPlaneVect =
-      referencePlane.orthogonal_vector() /
-      sqrt(referencePlane.orthogonal_vector().squared_length());
-
-  std::array<Kernel::FT, 2> validWedgeAngles{-M_PI, M_PI};
-  for (auto iter = begin; iter != end; ++iter) {
-    Kernel::Plane_3 curPointPlane = Kernel::Plane_3(*begin, *end, *iter);
-    // Is the current query plane is degenerate, we can use the default (all of
-    // (-PI,PI)) value of valid angles, as this point is coincident with the
-    // begin and end points. Else, we compute.
-    if (!curPointPlane.is_degenerate()) {
-      Kernel::FT distToWedgePivot =
-          sqrt(CGAL::squared_distance(*iter, wedgePivotLine));
-      // If the ball around current point of radius tolerance intersects the
-      // wedgePivot line, then, any point of intersection is always < tolerance
-      // away from the point, and is always in any plane that passes through
-      // the wedgePivot line. Thus, keep the validWedgeAngle unchanged for this
-      // case. Else, we compute.
-      if (tolerance >= distToWedgePivot) {
-        Kernel::FT ratio =
-            utils::clamp<Kernel::FT>(tolerance / distToWedgePivot, -1.0, 1.0);
-        Kernel::FT angleAboutPointPlane = abs(asin(ratio));
+  ++m_numPoints;
+}
 
-        Kernel::FT pointPlaneReferenceInnerProd =
-            (curPointPlane.orthogonal_vector() * normedPlaneVect) /
-            sqrt(curPointPlane.orthogonal_vector().squared_length());
-        pointPlaneReferenceInnerProd =
-            utils::clamp(pointPlaneReferenceInnerProd, -1.0, 1.0);
-        Kernel::FT pointPlaneReferenceAngle =
-            acos(pointPlaneReferenceInnerProd);
+Wedge WedgeTracker::wedge(const Kernel::Point_3& end, size_t numPoints) const {
+  const Wedge none{true, false, Eigen::Vector3d::Zero(), {}, 0};
+  return wedge(end, numPoints, none);
+}
 
-        validWedgeAngles[0] =
-            std::max(validWedgeAngles[0],
-                     pointPlaneReferenceAngle - angleAboutPointPlane);
-        validWedgeAngles[1] =
-            std::min(validWedgeAngles[1],
-                     pointPlaneReferenceAngle + angleAboutPointPlane);
+Wedge WedgeTracker::wedge(const Kernel::Point_3& end, size_t numPoints,
+                          const Wedge& from) const {
+  assert(from.numPoints <= numPoints);
+  DLOG_IF(ERROR, end == m_beginPoint)
+      << "WedgeTracker - pivot line through coincident points. This could "
+         "actually represent an entire circle, instead of a degenerate case "
+         "of all points being coincident and has to be properly handled.";
+  const Eigen::Vector3d pivot = (toEigen(end) - m_begin).normalized();
+  // An orthonormal frame orthogonal to the pivot line, to measure angles
+  // about it.
+  const Eigen::Vector3d e1 = pivot.unitOrthogonal();
+  const Eigen::Vector3d e2 = pivot.cross(e1);
+
+  // The points of a previous wedge are only approximately accounted for about
+  // the new pivot line. Confirm that the wedge is empty with all points.
+  auto empty = [&]() {
+    if (from.numPoints > 0) return wedge(end, numPoints);
+    return Wedge{false, false, pivot, {e1, e1}, numPoints};
+  };
 
-        // Early exit if no interval overlap already. No wedge is found in this
-        // case.
-        if (validWedgeAngles[0] > validWedgeAngles[1]) {
-          LOG(INFO) << "\t\t\tNo valid wedge found " << validWedgeAngles[0]
-                    << " " << validWedgeAngles[1] << std::endl;
-          return std::make_tuple(wedgeFound, wedgePlane1, wedgePlane2);
-        }
+  bool constrained = false;
+  std::array<Kernel::FT, 2> validWedgeAngles{0, 0};
+  if (from.constrained) {
+    // Re-project the bounds of the previous wedge about the new pivot line.
+    std::array<Eigen::Vector3d, 2> bounds;
+    for (size_t bound = 0; bound < 2; ++bound) {
+      bounds[bound] =
+          from.bounds[bound] - from.bounds[bound].dot(pivot) * pivot;
+      if (bounds[bound].squaredNorm() <=
+          std::numeric_limits<Kernel::FT>::epsilon()) {
+        return wedge(end, numPoints);
       }
     }
+    // Bounds that swapped over are past what the re-projection tracks.
+    Kernel::FT width = atan2(pivot.dot(bounds[0].cross(bounds[1])),
+                             bounds[0].dot(bounds[1]));
+    if (width < 0) return wedge(end, numPoints);
+    validWedgeAngles[0] = atan2(bounds[0].dot(e2), bounds[0].dot(e1));
+    validWedgeAngles[1] = validWedgeAngles[0] + width;
+    constrained = true;
   }
-  wedgeFound = true;
-  Kernel::Vector_3 unitWedgePivotVect = wedgePivotLine.to_vector();
-  unitWedgePivotVect =
-      unitWedgePivotVect / sqrt(unitWedgePivotVect.squared_length());
-
-  auto rotateAboutAxis = [](const Kernel::Vector_3& vector,
-                            const Kernel::Vector_3& axis, Kernel::FT angle) {
-    Eigen::AngleAxisf rotation(Eigen::AngleAxisf(
-        angle, Eigen::Vector3f(axis.x(), axis.y(), axis.z())));
-    Eigen::Vector3f rotated =
-        rotation * Eigen::Vector3f(vector.x(), vector.y(), vector.z());
-    return Kernel::Vector_3(rotated[0], rotated[1], rotated[2]);
-  };
-
-  Kernel::Vector_3 wedgePlane1Normal =
-      rotateAboutAxis(normedPlaneVect, unitWedgePivotVect, validWedgeAngles[0]);
-  Kernel::Vector_3 wedgePlane2Normal =
-      rotateAboutAxis(normedPlaneVect, unitWedgePivotVect, validWedgeAngles[1]);
-  return std::make_tuple(wedgeFound, Kernel::Plane_3(*begin, wedgePlane1Normal),
-                         Kernel::Plane_3(*begin, wedgePlane2Normal));
-}
 
-template <typename PointIter>
-std::tuple<bool, std::vector<Kernel::Point_3>> findCircleFit(
-    PointIter begin, PointIter end, const Kernel::Plane_3& searchPlane,
-    Kernel::FT tolerance) {
-  // Precondition -- there must be atleast three points for a circle fit.
-  assert(begin + 1 != end);
-
-  Kernel::FT sqTolerance = tolerance * tolerance;
-  std::vector<Kernel::Point_3> simplifiedSamples;
-  // Check if a line works.
-  Kernel::Segment_3 endPointsSegment(*begin, *end);
-  bool fLineValid = true;
-  for (auto iter = begin + 1; iter != end && fLineValid; ++iter) {
-    Kernel::FT squaredDist = CGAL::squared_distance(endPointsSegment, *iter);
-    if (squaredDist > sqTolerance) {
-      fLineValid = false;
-      LOG(INFO) << "\t\t\tTolerance exceeded for line by " << *iter << " "
-                << squaredDist << std::endl;
+  // Intersect with the intervals of the points added since the previous
+  // wedge.
+  auto constraint = std::lower_bound(
+      m_constraints.begin(), m_constraints.end(), from.numPoints,
+      [](const Constraint& constraint, size_t index) {
+        return constraint.index < index;
+      });
+  for (; constraint != m_constraints.end() && constraint->index < numPoints;
+       ++constraint) {
+    const Eigen::Vector3d& offset = constraint->offset;
+    Kernel::FT x = offset.dot(e1);
+    Kernel::FT y = offset.dot(e2);
+    Kernel::FT squaredDistToPivot = x * x + y * y;
+    // If the ball around the point of radius tolerance intersects the pivot
+    // line, any plane through the line is within tolerance.
+    if (squaredDistToPivot <= m_tolerance * m_tolerance) continue;
+
+    Kernel::FT angle = atan2(y, x);
+    Kernel::FT halfWidth = asin(m_tolerance / sqrt(squaredDistToPivot));
+    if (!constrained) {
+      validWedgeAngles = {angle - halfWidth, angle + halfWidth};
+      constrained = true;
+      continue;
+    }
+    // Planes are the same modulo PI. Compare against the copy of the point's
+    // interval closest to the current wedge.
+    Kernel::FT wedgeCenter = (validWedgeAngles[0] + validWedgeAngles[1]) / 2;
+    angle += M_PI * std::round((wedgeCenter - angle) / M_PI);
+    validWedgeAngles[0] = std::max(validWedgeAngles[0], angle - halfWidth);
+    validWedgeAngles[1] = std::min(validWedgeAngles[1], angle + halfWidth);
+    // Early exit if no interval overlap already. No wedge is found in this
+    // case.
+    if (validWedgeAngles[0] > validWedgeAngles[1]) {
+      LOG(INFO) << "\t\t\tNo valid wedge found " << validWedgeAngles[0] << " "
+                << validWedgeAngles[1] << std::endl;
+      return empty();
     }
-  }
-  if (fLineValid) {
-    simplifiedSamples.push_back(*begin);
-    LOG(INFO) << "\t\tFit line between " << *begin << " " << *end << std::endl;
-    return std::make_tuple(true, simplifiedSamples);
   }
 
-  bool fValidFitFound = false;
-  // Try fitting incrementally, a circle between begin and end, passing through
-  // a point in between begin and end, and that satisfies the tolerance
-  // criteria.
-  for (auto iter = begin + 1; iter != end && !fValidFitFound; ++iter) {
-    std::vector<Kernel::Point_3> simplifiedSamplesTry;
-    simplifiedSamplesTry.push_back(*begin);
-    if (!CGAL::collinear(*begin, *iter, *end)) {
-      Kernel::Circle_3 circleCandidate(*begin, *iter, *end);
-      Kernel::FT circleRadius = sqrt(circleCandidate.squared_radius());
-      bool fCircleValid = true;
-      for (auto iter = begin + 1; iter != end && fCircleValid; ++iter) {
-        Kernel::Point_3 pointCirclePlaneProjection =
-            circleCandidate.supporting_plane().projection(*iter);
-        Kernel::FT squaredDist =
-            CGAL::squared_distance(pointCirclePlaneProjection, *iter) +
-            abs(CGAL::squared_distance(circleCandidate.center(),
-                                       pointCirclePlaneProjection) -
-                circleCandidate.squared_radius());
-        if (squaredDist > sqTolerance) {
-          LOG(INFO) << "\t\t\tTolerance exceeded for circle c:"
-                    << circleCandidate.center() << " r:" << circleRadius
-                    << " by " << *iter << " " << squaredDist << std::endl;
-          fCircleValid = false;
-        } else {
-          LOG(INFO) << "\t\t\tTolerance for point "
-                    << pointCirclePlaneProjection << squaredDist << std::endl;
-          Kernel::Vector_3 unitCenterSegment(circleCandidate.center(),
-                                             pointCirclePlaneProjection);
-          unitCenterSegment =
-              unitCenterSegment / sqrt(unitCenterSegment.squared_length());
-          simplifiedSamplesTry.push_back(circleCandidate.center() +
-                                         unitCenterSegment * circleRadius);
-        }
-      }
-      fValidFitFound = fCircleValid;
-      if (fValidFitFound) {
-        LOG(INFO) << "\t\tFit circle c:" << circleCandidate.center()
-                  << " r:" << circleRadius << " between " << *begin << " "
-                  << *end << std::endl;
-        simplifiedSamples = std::move(simplifiedSamplesTry);
-        break;  // We are done searching as we have found 'a' fit -- this may
-                // not be optimal however. TODO msati3: Is this hacky?
-      }
-    }
+  // The plane at angle alpha contains the pivot, and the direction
+  // cos(alpha) e1 + sin(alpha) e2.
+  Wedge result{true, constrained, pivot, {}, numPoints};
+  for (size_t bound = 0; bound < 2; ++bound) {
+    result.bounds[bound] = std::cos(validWedgeAngles[bound]) * e1 +
+                           std::sin(validWedgeAngles[bound]) * e2;
   }
-  return std::tuple<bool, std::vector<Kernel::Point_3>>{fValidFitFound,
-                                                        simplifiedSamples};
+  return result;
+}
+
+Kernel::Plane_3 WedgeTracker::bisector(const Wedge& wedge) const {
+  // The bounds are less than PI apart, and their sum is along the bisecting
+  // direction.
+  Eigen::Vector3d normal =
+      wedge.pivot.cross(wedge.bounds[0] + wedge.bounds[1]);
+  return Kernel::Plane_3(m_beginPoint,
+                         Kernel::Vector_3(normal[0], normal[1], normal[2]));
 }
 
+}  // namespace circle_fit
+
 // Given a start point, try fitting as large a circle as possible (that goes
 // through as many points upto end), so that points in between are all at max
 // tolerance distance away from the plane.
 template <typename PointIter>
-std::tuple<bool, std::vector<Kernel::Point_3>, PointIter> greedyFitCircle(
+std::tuple<bool, CurvePrimitive_3, PointIter> greedyFitCircle(
     PointIter begin, PointIter end, float tolerance) {
-  Kernel::Circle_3 dummyCircle(Kernel::Point_3(1, 0, 0),
-                               Kernel::Point_3(0, 1, 0),
-                               Kernel::Point_3(-1, 0, 0));
-  std::vector<Kernel::Point_3> simplifiedSamples;
-  simplifiedSamples.push_back(*begin);
-  // Try increments of powers of two, to size largest range of points where a
-  // circle fits. Return with a line fit if the greedy fit is just requested for
-  // two consecutive points.
-  std::tuple<bool, std::vector<Kernel::Point_3>, PointIter> retVal{
-      true, simplifiedSamples, begin + 1};
+  // Return with a line fit if the greedy fit is just requested for two
+  // consecutive points.
+  std::tuple<bool, CurvePrimitive_3, PointIter> retVal{
+      true, CurvePrimitive_3::line(*begin, *(begin + 1)), begin + 1};
 
   // A single step remains. This will be a circle of infinite radius (line).
   if (begin + 2 == end) {
@@ -209,52 +161,67 @@ std::tuple<bool, std::vector<Kernel::Point_3>, PointIter> greedyFitCircle(
     return retVal;
   }
 
-  // We start with a found wedge -- the one that just leads to a straight line
-  // segment between the first and next point.
-  bool fFoundWedgeThisIter = true;
-  size_t curIncrement = 1;
-  PointIter curEnd = begin + curIncrement;
-  bool fAtEnd = false;
-
-  while (fFoundWedgeThisIter && !fAtEnd) {
-    fFoundWedgeThisIter = false;
-    // Advance from current position by curIncrement
-    for (size_t numIncrements = 0;
-         (numIncrements < curIncrement) && (curEnd != end);
-         ++numIncrements, ++curEnd) {
-    };
-    fAtEnd = (curEnd == end);
-    PointIter fitEnd = fAtEnd ? curEnd - 1 : curEnd;
+  // Points are fed to the wedge tracker once, as the fit end advances. Every
+  // fit tried ends past the last good one, and its wedge is evaluated
+  // incrementally from the wedge of that fit.
+  circle_fit::WedgeTracker wedgeTracker(*begin, tolerance);
+  circle_fit::Wedge goodWedge = wedgeTracker.wedge(*(begin + 1), 1);
+  const size_t lastOffset = (end - begin) - 1;
+  auto tryFit = [&](size_t fitOffset) {
+    PointIter fitEnd = begin + fitOffset;
+    while (wedgeTracker.numPoints() < fitOffset) {
+      wedgeTracker.addPoint(*(begin + wedgeTracker.numPoints()));
+    }
     LOG(INFO) << "\tTry fitting from " << *begin << " to " << *fitEnd
               << std::endl;
-    auto wedgeResult = findWedgeForTolerance(begin, fitEnd, tolerance);
-    // Stop searching when the next iteration does not yield a valid wedge.
-    if (std::get<0>(wedgeResult)) {
-      Kernel::Plane_3 wedgeBisector =
-          CGAL::bisector(std::get<1>(wedgeResult), std::get<2>(wedgeResult));
-      auto bestCircleFit =
-          findCircleFit(begin, fitEnd, wedgeBisector, tolerance);
-      if (std::get<0>(bestCircleFit)) {
-        retVal = std::make_tuple(std::get<0>(bestCircleFit),
-                                 std::move(std::get<1>(bestCircleFit)), fitEnd);
-        fFoundWedgeThisIter = true;
-      }
+    circle_fit::Wedge wedge = wedgeTracker.wedge(*fitEnd, fitOffset, goodWedge);
+    if (!wedge.valid) return false;
+    auto bestCircleFit = circle_fit::findCircleFit(
+        begin, fitEnd, wedgeTracker.bisector(wedge), tolerance);
+    if (!std::get<0>(bestCircleFit)) return false;
+    retVal = std::make_tuple(true, std::move(std::get<1>(bestCircleFit)),
+                             fitEnd);
+    goodWedge = wedge;
+    return true;
+  };
+
+  // Try increments of powers of two, to size the largest range of points where
+  // a circle fits. We start with the fit that just leads to a straight line
+  // segment between the first and next point.
+  size_t goodOffset = 1;
+  size_t badOffset = lastOffset + 1;
+  for (size_t increment = 1; goodOffset < lastOffset; increment *= 2) {
+    size_t fitOffset = std::min(goodOffset + increment, lastOffset);
+    if (!tryFit(fitOffset)) {
+      badOffset = fitOffset;
+      break;
+    }
+    goodOffset = fitOffset;
+  }
+
+  // Binary search for the largest end between the last fit found, and the
+  // first one that failed.
+  while (goodOffset + 1 < badOffset) {
+    size_t fitOffset = goodOffset + (badOffset - goodOffset) / 2;
+    if (tryFit(fitOffset)) {
+      goodOffset = fitOffset;
+    } else {
+      badOffset = fitOffset;
     }
-    curIncrement *= 2;
   }
   return retVal;
 }
 
-std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+constexpr float Polyline_3Simplifier::ARC_SAMPLING_TOLERANCE;
+
+std::tuple<size_t, Biarc_3> Polyline_3Simplifier::simplifyToArcs(
     const Polyline_3& input,
     const Polyline_3SimplificationStrategyNaiveBiarc& /**/) {
   auto current = input.begin();
   auto end = input.end();
 
-  Polyline_3 simplifiedLine;
-  size_t numPrimitivesSimplified = 0;
-  std::tuple<bool, std::vector<Kernel::Point_3>, Polyline_3::const_iterator>
-      fitResult;
+  Biarc_3 simplified;
+  std::tuple<bool, CurvePrimitive_3, Polyline_3::const_iterator> fitResult;
   do {
     LOG(INFO) << "Will begin next sample from " << *current << std::endl;
     fitResult = greedyFitCircle(current, end, m_tolerance);
@@ -262,14 +229,16 @@ std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
     DLOG_IF(ERROR, !std::get<0>(fitResult)) << "Could not fit any valid "
                                                "primitive? This should not "
                                                "happen without a buggy code";
-    std::vector<Kernel::Point_3>& simplifiedSamples = std::get<1>(fitResult);
-    for (auto iter = simplifiedSamples.begin(); iter != simplifiedSamples.end();
-         ++iter) {
-      simplifiedLine.addPoint(*iter);
-    }
-    numPrimitivesSimplified++;
+    simplified.addPrimitive(std::get<1>(fitResult));
   } while (current + 1 != end);
-  // Add the last point to the simplified result.
-  simplifiedLine.addPoint(*current);
-  return std::make_tuple(numPrimitivesSimplified, simplifiedLine);
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyNaiveBiarc& strategy) {
+  std::tuple<size_t, Biarc_3> arcs = simplifyToArcs(input, strategy);
+  return std::make_tuple(
+      std::get<0>(arcs),
+      std::get<1>(arcs).toPolyline(m_tolerance * ARC_SAMPLING_TOLERANCE));
 }
@@ -0,0 +1,55 @@
+#include <vector>
+
+#include "geometryTypes.h"
+#include "polyline.h"
+#include "simplification/parallelDouglasPeucker.h"
+#include "simplification/polyline_3Simplifier.h"
+#include "simplification/psimplAdapters.h"
+
+using Polyline_3 = Polyline<Kernel::Point_3>;
+
+namespace {
+
+Polyline_3 fromFlatCoordinates(const std::vector<FieldType>& coords) {
+  Polyline_3 polyline;
+  polyline.reserve(coords.size() / 3);
+  for (size_t coord = 0; coord < coords.size(); coord += 3) {
+    polyline.addPoint(
+        Kernel::Point_3(coords[coord], coords[coord + 1], coords[coord + 2]));
+  }
+  return polyline;
+}
+
+}  // end anonymous namespace
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplify(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyParallelDouglasPeucker& strategy) {
+  // Coordinates are read in double precision, straight off the points.
+  using CoordinateIterator = FlatCoordinateIterator<Polyline_3::const_iterator>;
+  std::vector<FieldType> simplifiedFlat;
+  parallelDouglasPeucker<3>(CoordinateIterator::begin(input.begin()),
+                            CoordinateIterator::end(input.begin(), input.end()),
+                            static_cast<FieldType>(m_tolerance),
+                            strategy.m_grainSize, simplifiedFlat);
+
+  Polyline_3 simplified = fromFlatCoordinates(simplifiedFlat);
+  return std::make_tuple(simplified.size(), simplified);
+}
+
+std::tuple<size_t, Polyline_3> Polyline_3Simplifier::simplifyWithinTolerance(
+    const Polyline_3& input,
+    const Polyline_3SimplificationStrategyParallelDouglasPeucker& strategy) {
+  // The recursion reads the coordinates by index, and thus, off a copy.
+  using CoordinateIterator = FlatCoordinateIterator<Polyline_3::const_iterator>;
+  const std::vector<FieldType> coords(
+      CoordinateIterator::begin(input.begin()),
+      CoordinateIterator::end(input.begin(), input.end()));
+  std::vector<FieldType> simplifiedFlat;
+  parallelClassicDouglasPeucker<3>(coords.data(), coords.size(),
+                                   static_cast<FieldType>(m_tolerance),
+                                   strategy.m_grainSize, simplifiedFlat);
+
+  Polyline_3 simplified = fromFlatCoordinates(simplifiedFlat);
+  return std::make_tuple(simplified.size(), simplified);
+}
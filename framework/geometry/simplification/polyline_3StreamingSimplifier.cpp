@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <utility>
+
+#include <CGAL/squared_distance_3.h>
+
+#include "simplification/polyline_3StreamingSimplifier.h"
+
+Polyline_3StreamingSimplifier::Polyline_3StreamingSimplifier(
+    FieldType tolerance, VertexSink sink, size_t maxWindowSize)
+    : m_squaredTolerance(tolerance * tolerance),
+      m_sink(std::move(sink)),
+      m_maxWindowSize(std::max<size_t>(maxWindowSize, 1)),
+      m_hasAnchor(false) {
+  m_window.reserve(m_maxWindowSize);
+}
+
+void Polyline_3StreamingSimplifier::addPoint(const Kernel::Point_3& point) {
+  if (!m_hasAnchor) {
+    emit(point);
+    return;
+  }
+
+  if (!m_window.empty() &&
+      (m_window.size() == m_maxWindowSize || !fitsWindow(point))) {
+    // The window so far is within tolerance of the segment from the anchor to
+    // its last point, which is thus final.
+    emit(m_window.back());
+    m_window.clear();
+  }
+  m_window.push_back(point);
+}
+
+void Polyline_3StreamingSimplifier::finish() {
+  if (!m_window.empty()) {
+    emit(m_window.back());
+  }
+  m_window.clear();
+  m_hasAnchor = false;
+}
+
+bool Polyline_3StreamingSimplifier::fitsWindow(
+    const Kernel::Point_3& point) const {
+  const Kernel::Segment_3 segment(m_anchor, point);
+  for (const Kernel::Point_3& windowPoint : m_window) {
+    if (CGAL::squared_distance(windowPoint, segment) > m_squaredTolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Polyline_3StreamingSimplifier::emit(const Kernel::Point_3& point) {
+  m_anchor = point;
+  m_hasAnchor = true;
+  m_sink(point);
+}
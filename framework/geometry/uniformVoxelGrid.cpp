@@ -1,26 +1,52 @@
-#include <CGAL/point_generators_3.h>
+#include <algorithm>
+#include <cmath>
 
 #include "uniformVoxelGrid.h"
 
 UniformVoxelGrid::UniformVoxelGrid(FieldType extent, size_t indexExtent)
-    : m_indexBounds(indexExtent, indexExtent, indexExtent),
-      m_gridIncrement(2 * extent / indexExtent) {
-  CGAL::Creator_uniform_3<FieldType, Kernel::Point_3> creator;
-  CGAL::points_on_cube_grid_3(extent, indexExtent * indexExtent * indexExtent,
-                              std::back_inserter(m_points), creator);
+    : m_extent(extent),
+      m_resolution(indexExtent),
+      m_gridIncrement(2 * extent / indexExtent),
+      m_indexBounds(indexExtent, indexExtent, indexExtent) {
+  CGAL_precondition(extent > 0);
+  CGAL_precondition(indexExtent != 0);
 }
 
 Kernel::Iso_cuboid_3 UniformVoxelGrid::voxelBoundsForLocation(
     const Kernel::Point_3& location) const {
-  // Scale by the grid increment, and round down.
-  Kernel::Vector_3 vector = (location - CGAL::ORIGIN) / m_gridIncrement;
+  // Scale by the grid increment relative to the lowest corner of the grid, and
+  // round down. Flooring (as opposed to truncation) keeps voxels closed below
+  // and open above across the whole grid.
+  Kernel::Vector_3 vector =
+      (location - Kernel::Point_3(-m_extent, -m_extent, -m_extent)) /
+      m_gridIncrement;
+  FieldType i = std::floor(vector.x());
+  FieldType j = std::floor(vector.y());
+  FieldType k = std::floor(vector.z());
 
-  Kernel::Vector_3 minPoint((int)vector.x() * m_gridIncrement,
-                            (int)vector.y() * m_gridIncrement,
-                            (int)vector.z() * m_gridIncrement);
-  Kernel::Vector_3 maxPoint(((int)vector.x() + 1) * m_gridIncrement,
-                            ((int)vector.y() + 1) * m_gridIncrement,
-                            ((int)vector.z() + 1) * m_gridIncrement);
-  return Kernel::Iso_cuboid_3(minPoint.x(), minPoint.y(), minPoint.z(),
-                              maxPoint.x(), maxPoint.y(), maxPoint.z());
+  const FieldType resolution = m_resolution;
+  if (i < 0 || j < 0 || k < 0 || i >= resolution || j >= resolution ||
+      k >= resolution) {
+    return Kernel::Iso_cuboid_3(location, location);
+  }
+
+  return Kernel::Iso_cuboid_3(-m_extent + i * m_gridIncrement,
+                              -m_extent + j * m_gridIncrement,
+                              -m_extent + k * m_gridIncrement,
+                              -m_extent + (i + 1) * m_gridIncrement,
+                              -m_extent + (j + 1) * m_gridIncrement,
+                              -m_extent + (k + 1) * m_gridIncrement);
+}
+
+std::vector<UniformVoxelGrid::Range> UniformVoxelGrid::splitRange(
+    size_t numRanges) const {
+  const size_t numVoxels = size();
+  numRanges = std::max<size_t>(1, std::min(numRanges, numVoxels));
+  std::vector<Range> ranges;
+  ranges.reserve(numRanges);
+  for (size_t range = 0; range < numRanges; ++range) {
+    ranges.emplace_back(begin() + range * numVoxels / numRanges,
+                        begin() + (range + 1) * numVoxels / numRanges);
+  }
+  return ranges;
 }
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "voxelMesher.h"
+
+VoxelMesher::VoxelMesher(const UniformVoxelGrid& grid)
+    : m_resolution(grid.shape(0)),
+      m_origin(grid.voxelCenter(0, 0, 0).x() - grid.voxelSize() / 2),
+      m_voxelSize(grid.voxelSize()) {}
+
+void VoxelMesher::build(const Occupancy& occupancy, IndexedTriangleMesh& mesh,
+                        bool mergeFaces) {
+  CGAL_precondition(occupancy.resolution() == m_resolution);
+  mesh.clear();
+  m_nodeVertices.clear();
+  m_faceMask.assign(m_resolution * m_resolution, 0);
+  for (int axis = 0; axis < 3; ++axis) {
+    buildAxis(occupancy, axis, mergeFaces, mesh);
+  }
+}
+
+void VoxelMesher::buildAxis(const Occupancy& occupancy, int axis,
+                            bool mergeFaces, IndexedTriangleMesh& mesh) {
+  // The slice plane is spanned by the u and v axes, such that u x v points
+  // along axis.
+  const int uAxis = (axis + 1) % 3;
+  const int vAxis = (axis + 2) % 3;
+  auto occupied = [&](size_t slice, size_t u, size_t v) {
+    size_t index[3];
+    index[axis] = slice;
+    index[uAxis] = u;
+    index[vAxis] = v;
+    return occupancy.at(index[0], index[1], index[2]) != 0;
+  };
+
+  // Slice plane s separates the voxel layers s - 1 and s.
+  for (size_t slice = 0; slice <= m_resolution; ++slice) {
+    bool hasFaces = false;
+    for (size_t v = 0; v < m_resolution; ++v) {
+      for (size_t u = 0; u < m_resolution; ++u) {
+        bool below = slice > 0 && occupied(slice - 1, u, v);
+        bool above = slice < m_resolution && occupied(slice, u, v);
+        std::int8_t face = below == above ? 0 : (below ? 1 : -1);
+        m_faceMask[u + m_resolution * v] = face;
+        hasFaces = hasFaces || face != 0;
+      }
+    }
+    if (!hasFaces) continue;
+
+    for (size_t v = 0; v < m_resolution; ++v) {
+      for (size_t u = 0; u < m_resolution;) {
+        const std::int8_t face = m_faceMask[u + m_resolution * v];
+        if (face == 0) {
+          ++u;
+          continue;
+        }
+
+        size_t width = 1, height = 1;
+        if (mergeFaces) {
+          // Grow along u as far as the faces match, and then along v for as
+          // long as whole rows of that width match.
+          while (u + width < m_resolution &&
+                 m_faceMask[u + width + m_resolution * v] == face) {
+            ++width;
+          }
+          bool rowMatches = true;
+          while (v + height < m_resolution && rowMatches) {
+            const std::int8_t* row =
+                m_faceMask.data() + u + m_resolution * (v + height);
+            for (size_t offset = 0; offset < width; ++offset) {
+              if (row[offset] != face) {
+                rowMatches = false;
+                break;
+              }
+            }
+            if (rowMatches) ++height;
+          }
+          for (size_t row = v; row < v + height; ++row) {
+            std::fill_n(m_faceMask.begin() + u + m_resolution * row, width, 0);
+          }
+        }
+
+        addQuad(axis, slice, u, v, width, height, face > 0, mesh);
+        u += width;
+      }
+    }
+  }
+}
+
+void VoxelMesher::addQuad(int axis, size_t slice, size_t u, size_t v,
+                          size_t width, size_t height, bool facesUp,
+                          IndexedTriangleMesh& mesh) {
+  const int uAxis = (axis + 1) % 3;
+  const int vAxis = (axis + 2) % 3;
+  const size_t cornerU[] = {u, u + width, u + width, u};
+  const size_t cornerV[] = {v, v, v + height, v + height};
+  IndexType corners[4];
+  for (int corner = 0; corner < 4; ++corner) {
+    size_t node[3];
+    node[axis] = slice;
+    node[uAxis] = cornerU[corner];
+    node[vAxis] = cornerV[corner];
+    corners[corner] = nodeVertex(node[0], node[1], node[2], mesh);
+  }
+
+  // The corners run counterclockwise about +axis.
+  if (facesUp) {
+    mesh.addTriangle(corners[0], corners[1], corners[2]);
+    mesh.addTriangle(corners[0], corners[2], corners[3]);
+  } else {
+    mesh.addTriangle(corners[0], corners[2], corners[1]);
+    mesh.addTriangle(corners[0], corners[3], corners[2]);
+  }
+}
+
+VoxelMesher::IndexType VoxelMesher::nodeVertex(size_t i, size_t j, size_t k,
+                                               IndexedTriangleMesh& mesh) {
+  const std::uint64_t nodesPerAxis = m_resolution + 1;
+  const std::uint64_t key = i + nodesPerAxis * (j + nodesPerAxis * k);
+  auto inserted = m_nodeVertices.emplace(key, 0);
+  if (inserted.second) {
+    inserted.first->second = mesh.addVertex(m_origin + i * m_voxelSize,
+                                            m_origin + j * m_voxelSize,
+                                            m_origin + k * m_voxelSize);
+  }
+  return inserted.first->second;
+}
@@ -0,0 +1,108 @@
+#ifndef _FRAMEWORK_GEOMETRY_BIARC_3_H_
+#define _FRAMEWORK_GEOMETRY_BIARC_3_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "geometryTypes.h"
+#include "polyline.h"
+
+// A line segment, or a circular arc, of a curve made of lines and arcs.
+//
+// An arc is given by its center, the unit normal of its plane, its end points,
+// and its sweep: the signed angle from start to end, counter clockwise about
+// the normal when positive. |sweep| is less than 2 PI.
+struct CurvePrimitive_3 {
+  enum Type { LINE, ARC };
+
+  static CurvePrimitive_3 line(const Kernel::Point_3& start,
+                               const Kernel::Point_3& end) {
+    return CurvePrimitive_3{LINE, start, end, start, Kernel::Vector_3(0, 0, 0),
+                            0};
+  }
+
+  static CurvePrimitive_3 arc(const Kernel::Point_3& center,
+                              const Kernel::Vector_3& normal,
+                              const Kernel::Point_3& start,
+                              const Kernel::Point_3& end, FieldType sweep) {
+    return CurvePrimitive_3{ARC, start, end, center, normal, sweep};
+  }
+
+  bool isArc() const { return type == ARC; }
+
+  FieldType radius() const {
+    return std::sqrt(CGAL::squared_distance(center, start));
+  }
+
+  FieldType length() const {
+    return isArc() ? std::abs(sweep) * radius()
+                   : std::sqrt(CGAL::squared_distance(start, end));
+  }
+
+  // The point at fraction t in [0, 1] of the primitive
+  Kernel::Point_3 pointAt(FieldType t) const {
+    if (!isArc()) return start + t * (end - start);
+    const Kernel::Vector_3 radial = start - center;
+    const FieldType angle = t * sweep;
+    return center + std::cos(angle) * radial +
+           std::sin(angle) * CGAL::cross_product(normal, radial);
+  }
+
+  // Number of chords that approximate the primitive to within maxChordError
+  size_t numChords(FieldType maxChordError) const {
+    if (!isArc()) return 1;
+    // The chord of an arc of angle a is at most r (1 - cos(a / 2)) off it.
+    const FieldType r = radius();
+    const FieldType maxStep =
+        maxChordError < r ? 2 * std::acos(1 - maxChordError / r) : M_PI;
+    return std::max<size_t>(1, std::ceil(std::abs(sweep) / maxStep));
+  }
+
+  Type type;
+  Kernel::Point_3 start;
+  Kernel::Point_3 end;
+  Kernel::Point_3 center;
+  Kernel::Vector_3 normal;
+  FieldType sweep;
+};
+
+// A curve made of consecutive lines and circular arcs, each starting where the
+// previous one ends. This is the native output of the biarc simplification,
+// with one primitive per fitted line or circle, and the input to G-code
+// export.
+class Biarc_3 {
+ public:
+  using const_iterator = std::vector<CurvePrimitive_3>::const_iterator;
+
+  void addPrimitive(const CurvePrimitive_3& primitive) {
+    m_primitives.push_back(primitive);
+  }
+
+  // The size of a Biarc_3 is the number of primitives it contains
+  size_t size() const { return m_primitives.size(); }
+
+  const_iterator begin() const { return m_primitives.begin(); }
+  const_iterator end() const { return m_primitives.end(); }
+
+  // Approximates the curve by a polyline whose chords are within
+  // maxChordError of the arcs, for display and for polyline consumers.
+  Polyline<Kernel::Point_3> toPolyline(FieldType maxChordError) const {
+    Polyline<Kernel::Point_3> polyline;
+    if (m_primitives.empty()) return polyline;
+    polyline.addPoint(m_primitives.front().start);
+    for (const CurvePrimitive_3& primitive : m_primitives) {
+      const size_t numChords = primitive.numChords(maxChordError);
+      for (size_t chord = 1; chord < numChords; ++chord) {
+        polyline.addPoint(primitive.pointAt(FieldType(chord) / numChords));
+      }
+      polyline.addPoint(primitive.end);
+    }
+    return polyline;
+  }
+
+ private:
+  std::vector<CurvePrimitive_3> m_primitives;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_BIARC_3_H_
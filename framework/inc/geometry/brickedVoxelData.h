@@ -0,0 +1,195 @@
+#ifndef _FRAMEWORK_GEOMETRY_BRICKED_VOXEL_DATA_H_
+#define _FRAMEWORK_GEOMETRY_BRICKED_VOXEL_DATA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "uniformVoxelGrid.h"
+
+// Per voxel payload storage (field values, occupancy, gradients, ...) for a
+// UniformVoxelGrid. Voxels are grouped into bricks of BRICK_SIZE^3 voxels,
+// stored contiguously. Within a brick, voxels are laid out in Morton (Z)
+// order, such that the 2x2x2 blocks, 4x4x4 blocks and so on of a brick are
+// contiguous. Bricks are stored with the brick i index varying fastest.
+//
+// A voxel and its 26 neighbours thus mostly share a brick, and a few cache
+// lines, which is what stencil operations walking over large grids need. A
+// row major layout puts the k neighbours of a voxel a whole slab apart.
+//
+// Grids whose resolution is not a multiple of BRICK_SIZE have partially
+// filled bricks at the upper end. The padding voxels are never exposed.
+//
+// Payloads are accessed by reference, so T may not be bool. Use uint8_t for
+// occupancy.
+template <typename T>
+class BrickedVoxelData {
+ public:
+  static constexpr size_t BRICK_BITS = 3;
+  static constexpr size_t BRICK_SIZE = 1 << BRICK_BITS;
+  static constexpr size_t BRICK_VOXELS = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+
+  // Read only access to a voxel and its neighbourhood. Neighbour accesses that
+  // stay within the brick of the voxel are resolved off the brick directly.
+  // Neighbours outside the grid are clamped to the grid boundary, which is
+  // the usual boundary treatment for finite difference stencils.
+  class Cursor {
+   public:
+    Cursor(const BrickedVoxelData& data, size_t i, size_t j, size_t k)
+        : m_data(&data) {
+      moveTo(i, j, k);
+    }
+
+    void moveTo(size_t i, size_t j, size_t k) {
+      m_i = i;
+      m_j = j;
+      m_k = k;
+      m_brick = m_data->m_values.data() +
+                m_data->brickIndex(i, j, k) * BRICK_VOXELS;
+      m_localI = i & BRICK_MASK;
+      m_localJ = j & BRICK_MASK;
+      m_localK = k & BRICK_MASK;
+    }
+
+    const T& value() const {
+      return m_brick[mortonOffset(m_localI, m_localJ, m_localK)];
+    }
+
+    // The value of the voxel at offset (di, dj, dk) from the cursor.
+    const T& neighbor(int di, int dj, int dk) const {
+      const int ni = m_localI + di;
+      const int nj = m_localJ + dj;
+      const int nk = m_localK + dk;
+      // Cast to unsigned folds the < 0 test into the < BRICK_SIZE test.
+      if (unsigned(ni) < BRICK_SIZE && unsigned(nj) < BRICK_SIZE &&
+          unsigned(nk) < BRICK_SIZE && m_i + di < m_data->m_resolution &&
+          m_j + dj < m_data->m_resolution &&
+          m_k + dk < m_data->m_resolution) {
+        return m_brick[mortonOffset(ni, nj, nk)];
+      }
+      return m_data->at(m_data->clamp(m_i, di), m_data->clamp(m_j, dj),
+                        m_data->clamp(m_k, dk));
+    }
+
+    size_t i() const { return m_i; }
+    size_t j() const { return m_j; }
+    size_t k() const { return m_k; }
+
+   private:
+    const BrickedVoxelData* m_data;
+    const T* m_brick;
+    size_t m_i, m_j, m_k;
+    unsigned m_localI, m_localJ, m_localK;
+  };
+
+  explicit BrickedVoxelData(const UniformVoxelGrid& grid,
+                            const T& value = T())
+      : BrickedVoxelData(grid.shape(0), value) {}
+
+  // Storage for a cubical grid of resolution voxels along each dimension
+  explicit BrickedVoxelData(size_t resolution, const T& value = T())
+      : m_resolution(resolution),
+        m_bricksPerAxis((resolution + BRICK_SIZE - 1) / BRICK_SIZE),
+        m_values(m_bricksPerAxis * m_bricksPerAxis * m_bricksPerAxis *
+                     BRICK_VOXELS,
+                 value) {}
+
+  T& at(size_t i, size_t j, size_t k) {
+    return m_values[storageIndex(i, j, k)];
+  }
+  const T& at(size_t i, size_t j, size_t k) const {
+    return m_values[storageIndex(i, j, k)];
+  }
+  T& at(const Index_3& index) {
+    return at(std::get<0>(index), std::get<1>(index), std::get<2>(index));
+  }
+  const T& at(const Index_3& index) const {
+    return at(std::get<0>(index), std::get<1>(index), std::get<2>(index));
+  }
+
+  Cursor cursor(size_t i, size_t j, size_t k) const {
+    return Cursor(*this, i, j, k);
+  }
+
+  void fill(const T& value) {
+    std::fill(m_values.begin(), m_values.end(), value);
+  }
+
+  // Calls fn(i, j, k, value) for every voxel, brick by brick, so that the
+  // payloads are visited in storage order. Bricks are processed in parallel,
+  // and thus, fn must be safe to call concurrently for distinct voxels.
+  template <typename Fn>
+  void forEachVoxel(Fn fn) {
+    const long numBricks = m_bricksPerAxis * m_bricksPerAxis * m_bricksPerAxis;
+#pragma omp parallel for schedule(static)
+    for (long brick = 0; brick < numBricks; ++brick) {
+      const size_t brickI = (brick % m_bricksPerAxis) * BRICK_SIZE;
+      const size_t brickJ =
+          ((brick / m_bricksPerAxis) % m_bricksPerAxis) * BRICK_SIZE;
+      const size_t brickK =
+          (brick / (m_bricksPerAxis * m_bricksPerAxis)) * BRICK_SIZE;
+      T* values = m_values.data() + brick * BRICK_VOXELS;
+      for (size_t offset = 0; offset < BRICK_VOXELS; ++offset) {
+        const size_t i = brickI + compact(offset);
+        const size_t j = brickJ + compact(offset >> 1);
+        const size_t k = brickK + compact(offset >> 2);
+        if (i < m_resolution && j < m_resolution && k < m_resolution) {
+          fn(i, j, k, values[offset]);
+        }
+      }
+    }
+  }
+
+  // Position of voxel (i, j, k) in the underlying storage
+  size_t storageIndex(size_t i, size_t j, size_t k) const {
+    return brickIndex(i, j, k) * BRICK_VOXELS +
+           mortonOffset(i & BRICK_MASK, j & BRICK_MASK, k & BRICK_MASK);
+  }
+
+  size_t resolution() const { return m_resolution; }
+  size_t size() const { return m_resolution * m_resolution * m_resolution; }
+
+ private:
+  static constexpr size_t BRICK_MASK = BRICK_SIZE - 1;
+
+  // Interleaves the bits of the local (within brick) voxel coordinates.
+  static size_t mortonOffset(size_t i, size_t j, size_t k) {
+    return spread(i) | (spread(j) << 1) | (spread(k) << 2);
+  }
+
+  // Spreads the BRICK_BITS low bits of value two bits apart
+  static size_t spread(size_t value) {
+    return (value & 1) | ((value & 2) << 2) | ((value & 4) << 4);
+  }
+
+  // Inverse of spread, for every third bit of value
+  static size_t compact(size_t value) {
+    return (value & 1) | ((value >> 2) & 2) | ((value >> 4) & 4);
+  }
+
+  size_t brickIndex(size_t i, size_t j, size_t k) const {
+    return (i >> BRICK_BITS) +
+           m_bricksPerAxis *
+               ((j >> BRICK_BITS) + m_bricksPerAxis * (k >> BRICK_BITS));
+  }
+
+  size_t clamp(size_t index, int offset) const {
+    long shifted = static_cast<long>(index) + offset;
+    return std::min<long>(std::max<long>(shifted, 0), m_resolution - 1);
+  }
+
+  size_t m_resolution;
+  size_t m_bricksPerAxis;
+  std::vector<T> m_values;
+};
+
+template <typename T>
+constexpr size_t BrickedVoxelData<T>::BRICK_BITS;
+template <typename T>
+constexpr size_t BrickedVoxelData<T>::BRICK_SIZE;
+template <typename T>
+constexpr size_t BrickedVoxelData<T>::BRICK_VOXELS;
+template <typename T>
+constexpr size_t BrickedVoxelData<T>::BRICK_MASK;
+
+#endif  //_FRAMEWORK_GEOMETRY_BRICKED_VOXEL_DATA_H_
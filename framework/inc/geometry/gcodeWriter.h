@@ -0,0 +1,38 @@
+#ifndef _FRAMEWORK_GEOMETRY_GCODE_WRITER_H_
+#define _FRAMEWORK_GEOMETRY_GCODE_WRITER_H_
+
+#include <iosfwd>
+#include <string>
+
+#include "biarc_3.h"
+
+struct GCodeWriterParams {
+  // Feed rate, written with the first move, and omitted if 0.
+  double feed_rate = 0;
+  // Digits after the decimal point of coordinates.
+  int precision = 4;
+  // Arcs whose normal is within this angle (in radians) of a coordinate axis
+  // are written as G02/G03 arcs in the matching plane (G17, G18 or G19).
+  double plane_angle_tolerance = 1e-6;
+  // Other arcs are written as G01 moves, with chords within this distance of
+  // the arc.
+  double linearization_tolerance = 1e-3;
+};
+
+// Writes curves of lines and arcs out as G-code toolpaths: a rapid move to the
+// start of the curve, then G01 moves for lines and G02 (clockwise) or G03
+// (counter clockwise) moves for arcs, with the center given by its I, J, K
+// offset from the arc start. Coordinates are absolute (G90).
+class GCodeWriter {
+ public:
+  explicit GCodeWriter(const GCodeWriterParams& params = GCodeWriterParams())
+      : m_params(params) {}
+
+  void write(const Biarc_3& curve, std::ostream& out) const;
+  bool write(const Biarc_3& curve, const std::string& filePath) const;
+
+ private:
+  GCodeWriterParams m_params;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_GCODE_WRITER_H_
@@ -0,0 +1,59 @@
+#ifndef _FRAMEWORK_GEOMETRY_INDEXED_TRIANGLE_MESH_H_
+#define _FRAMEWORK_GEOMETRY_INDEXED_TRIANGLE_MESH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "geometryConstants.h"
+
+// A flat, indexed triangle mesh. Vertex positions are stored as packed float
+// triples, and each triangle is a triple of 32-bit indices into the vertex
+// array. This is the layout in which the mesh is uploaded to the GPU, and
+// thus, renderers can consume the buffers without any repacking.
+class IndexedTriangleMesh {
+ public:
+  using IndexType = std::uint32_t;
+  static constexpr unsigned short COORDINATES_PER_VERTEX = 3;
+
+  void reserve(size_t numVertices, size_t numTriangles) {
+    m_positions.reserve(COORDINATES_PER_VERTEX * numVertices);
+    m_indices.reserve(VERTICES_PER_TRIANGLE * numTriangles);
+  }
+
+  void clear() {
+    m_positions.clear();
+    m_indices.clear();
+  }
+
+  // Appends a vertex, and returns its index.
+  IndexType addVertex(float x, float y, float z) {
+    IndexType index = static_cast<IndexType>(numVertices());
+    m_positions.push_back(x);
+    m_positions.push_back(y);
+    m_positions.push_back(z);
+    return index;
+  }
+
+  void addTriangle(IndexType v0, IndexType v1, IndexType v2) {
+    m_indices.push_back(v0);
+    m_indices.push_back(v1);
+    m_indices.push_back(v2);
+  }
+
+  size_t numVertices() const {
+    return m_positions.size() / COORDINATES_PER_VERTEX;
+  }
+  size_t numTriangles() const {
+    return m_indices.size() / VERTICES_PER_TRIANGLE;
+  }
+  bool empty() const { return m_indices.empty(); }
+
+  const std::vector<float>& positions() const { return m_positions; }
+  const std::vector<IndexType>& indices() const { return m_indices; }
+
+ private:
+  std::vector<float> m_positions;
+  std::vector<IndexType> m_indices;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_INDEXED_TRIANGLE_MESH_H_
@@ -0,0 +1,42 @@
+#ifndef _FRAMEWORK_GEOMETRY_PLY_MESH_WRITER_H_
+#define _FRAMEWORK_GEOMETRY_PLY_MESH_WRITER_H_
+
+#include <string>
+#include <thread>
+
+#include "indexedTriangleMesh.h"
+
+// Writes indexed triangle meshes out as binary PLY files. Writes happen on a
+// background thread, with vertex and face data streamed out in large buffered
+// chunks. If the output path ends with ".gz", and the framework has been built
+// with zlib, the output is gzip compressed.
+//
+// Only one write is in flight at a time -- a new write waits for the pending
+// one to complete. The destructor waits for any pending write.
+class PlyMeshWriter {
+ public:
+  // Size of the staging buffer that is handed to the output stream at once.
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+  PlyMeshWriter();
+  PlyMeshWriter(const PlyMeshWriter&) = delete;
+  PlyMeshWriter& operator=(const PlyMeshWriter&) = delete;
+  ~PlyMeshWriter();
+
+  // Takes ownership of the mesh, and writes it to filePath in the background.
+  void writeAsync(IndexedTriangleMesh mesh, const std::string& filePath);
+
+  // Blocks until the pending write, if any, is done. Returns the success of
+  // the last completed write.
+  bool wait();
+
+  // Synchronously writes mesh to filePath.
+  static bool write(const IndexedTriangleMesh& mesh,
+                    const std::string& filePath);
+
+ private:
+  std::thread m_writerThread;
+  bool m_lastWriteSucceeded;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_PLY_MESH_WRITER_H_
@@ -3,6 +3,7 @@
 
 #include <boost/iterator/iterator_adaptor.hpp>
 
+#include <functional>
 #include <vector>
 
 #include <CGAL/circulator.h>
@@ -33,6 +34,9 @@ class Polyline {
   // The size of a Polyline is the number of points it contains
   size_t size() const { return m_points.size(); }
 
+  // Preallocate for numPoints points
+  void reserve(size_t numPoints) { m_points.reserve(numPoints); }
+
   // Add a point at specified location to the Polyline.
   void addPoint(iterator iter, const PointType& point) {
     m_points.insert(iter, point);
@@ -128,5 +132,10 @@ bool buildPolylineFromObj(const std::string& filePath,
 template <typename PointType>
 bool buildPolylineFromVertexList(const std::string& filePath,
                                  Polyline<PointType>& polyline);
+// Calls onVertex for each vertex of a vertex list file, as it is read, for
+// consumers that process the vertices without buffering them all.
+template <typename PointType>
+bool readVertexList(const std::string& filePath,
+                    const std::function<void(const PointType&)>& onVertex);
 
 #endif  //_FRAMWORK_GEOMETRY_POLYLINE_H_
@@ -0,0 +1,295 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_CIRCLE_FIT_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_CIRCLE_FIT_H_
+
+#include <math.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <Eigen/Dense>
+
+#include "biarc_3.h"
+#include "geometryTypes.h"
+
+// Building blocks of the greedy circle fit of the naive biarc simplification.
+namespace circle_fit {
+
+inline Eigen::Vector3d toEigen(const Kernel::Point_3& point) {
+  return Eigen::Vector3d(point.x(), point.y(), point.z());
+}
+
+// The arc of the circle about center, in the plane of the (unit) normal, that
+// goes from start to end through via.
+inline CurvePrimitive_3 arcThrough(const Eigen::Vector3d& center,
+                                   const Eigen::Vector3d& normal,
+                                   const Kernel::Point_3& start,
+                                   const Kernel::Point_3& via,
+                                   const Kernel::Point_3& end) {
+  // Angles counter clockwise about the normal, from start, in [0, 2 PI).
+  const Eigen::Vector3d radial = toEigen(start) - center;
+  const Eigen::Vector3d tangential = normal.cross(radial);
+  auto angleOf = [&](const Kernel::Point_3& point) {
+    Eigen::Vector3d offset = toEigen(point) - center;
+    Kernel::FT angle = atan2(offset.dot(tangential), offset.dot(radial));
+    return angle < 0 ? angle + 2 * M_PI : angle;
+  };
+  const Kernel::FT endAngle = angleOf(end);
+  const Kernel::FT sweep =
+      angleOf(via) <= endAngle ? endAngle : endAngle - 2 * M_PI;
+  return CurvePrimitive_3::arc(
+      Kernel::Point_3(center[0], center[1], center[2]),
+      Kernel::Vector_3(normal[0], normal[1], normal[2]), start, end, sweep);
+}
+
+// A wedge of planes that contain the pivot line through a begin point, and
+// that are within tolerance of some points.
+struct Wedge {
+  // Whether the wedge is non-empty
+  bool valid;
+  // Whether any point constrained the wedge. Unconstrained wedges include all
+  // the planes through the pivot line.
+  bool constrained;
+  // The unit direction of the pivot line
+  Eigen::Vector3d pivot;
+  // Unit directions, orthogonal to the pivot, spanning the two planes that
+  // bound the wedge, counter clockwise about the pivot from the first to the
+  // second.
+  std::array<Eigen::Vector3d, 2> bounds;
+  // The number of points along the polyline, from the begin point, that the
+  // wedge accounts for
+  size_t numPoints;
+};
+
+// Tracks the wedge of planes that contain the line through a fixed begin
+// point and a (moving) end point, and that are within tolerance of the points
+// seen so far. This is the family of planes in which a circle fit may be
+// searched for.
+//
+// The planes through the pivot line are parametrized by an angle about it. A
+// point at distance d > tolerance from the pivot line, at angle phi about it,
+// is within tolerance of the planes at angles phi +- asin(tolerance / d)
+// (modulo PI). Points within tolerance of the pivot line are within tolerance
+// of any plane through it, and do not constrain the wedge. The wedge is the
+// intersection of the intervals over all points.
+//
+// Points are preprocessed once, as they are added: their offset from the
+// begin point is cached, and points within tolerance of the begin point are
+// dropped right away. A wedge is then evaluated incrementally, from the wedge
+// of a previous end: the two planes that bound it are re-projected about the
+// new pivot line, and intersected with the intervals of the points added
+// since only. This is O(1) per point over the greedy search for a fit, rather
+// than O(k) per evaluation of a wedge of k points.
+//
+// Re-projecting the bounds does not track the intervals of the earlier points
+// exactly as the pivot moves. The incremental wedge may thus include planes
+// the exact one does not, which is harmless as the fit searched for in the
+// wedge is verified against all points. It may also turn out empty when the
+// exact one is not, and is then recomputed exactly from all points before
+// being reported empty.
+class WedgeTracker {
+ public:
+  WedgeTracker(const Kernel::Point_3& begin, Kernel::FT tolerance);
+
+  // Adds the next point along the polyline.
+  void addPoint(const Kernel::Point_3& point);
+
+  size_t numPoints() const { return m_numPoints; }
+
+  // Computes the wedge for the pivot line through the begin point and end,
+  // constrained by the first numPoints points added.
+  Wedge wedge(const Kernel::Point_3& end, size_t numPoints) const;
+
+  // Same as above, starting off the wedge from, of a previous end. Only the
+  // points added after the first from.numPoints ones, up to numPoints, are
+  // intersected.
+  Wedge wedge(const Kernel::Point_3& end, size_t numPoints,
+              const Wedge& from) const;
+
+  // The plane that bisects a valid wedge. Any plane through the pivot line
+  // bisects an unconstrained one.
+  Kernel::Plane_3 bisector(const Wedge& wedge) const;
+
+ private:
+  // A point that constrains the wedge, by its index along the polyline, and
+  // its offset from the begin point.
+  struct Constraint {
+    size_t index;
+    Eigen::Vector3d offset;
+  };
+
+  Eigen::Vector3d m_begin;
+  Kernel::Point_3 m_beginPoint;
+  Kernel::FT m_tolerance;
+  size_t m_numPoints;
+  std::vector<Constraint> m_constraints;
+};
+
+// Fits a circle through begin and end, lying in the search plane, to the
+// points in between, in the algebraic least squares sense (Kasa fit,
+// constrained to pass through the end points). In the plane, with begin at
+// the origin and end at (L, 0), the center of such a circle is (L / 2, t),
+// and the algebraic residual of (x, y) is x^2 + y^2 - L x - 2 t y, which is
+// linear in t. The candidate is thus found in a single pass, and then
+// verified against the tolerance in another. Returns whether the candidate
+// is within tolerance, and if so, the arc from begin to end.
+template <typename PointIter>
+std::tuple<bool, CurvePrimitive_3> fitCircleLeastSquares(
+    PointIter begin, PointIter end, const Kernel::Plane_3& searchPlane,
+    Kernel::FT tolerance) {
+  const auto noFit = std::make_tuple(false, CurvePrimitive_3());
+  const Eigen::Vector3d origin = toEigen(*begin);
+  const Eigen::Vector3d chord = toEigen(*end) - origin;
+  const Kernel::FT chordLength = chord.norm();
+  Eigen::Vector3d normal(searchPlane.orthogonal_vector().x(),
+                         searchPlane.orthogonal_vector().y(),
+                         searchPlane.orthogonal_vector().z());
+  if (chordLength == 0 || normal.squaredNorm() == 0) return noFit;
+  // The frame of the search plane. The plane contains the chord, but make
+  // the frame orthonormal regardless.
+  const Eigen::Vector3d uAxis = chord / chordLength;
+  normal = (normal - normal.dot(uAxis) * uAxis).normalized();
+  const Eigen::Vector3d vAxis = normal.cross(uAxis);
+
+  // Plane coordinates, and heights off the plane, of the inner points
+  const size_t numPoints = (end - begin) - 1;
+  std::vector<Kernel::FT> xs(numPoints), ys(numPoints), hs(numPoints);
+  Kernel::FT residualDotY = 0;
+  Kernel::FT sqNormY = 0;
+  size_t point = 0;
+  for (auto iter = begin + 1; iter != end; ++iter, ++point) {
+    Eigen::Vector3d offset = toEigen(*iter) - origin;
+    Kernel::FT x = offset.dot(uAxis);
+    Kernel::FT y = offset.dot(vAxis);
+    xs[point] = x;
+    ys[point] = y;
+    hs[point] = offset.dot(normal);
+    residualDotY += (x * x + y * y - chordLength * x) * y;
+    sqNormY += y * y;
+  }
+  // All points on the chord line. A line would be the better fit here.
+  if (sqNormY == 0) return noFit;
+
+  const Kernel::FT centerX = chordLength / 2;
+  const Kernel::FT centerY = residualDotY / (2 * sqNormY);
+  const Kernel::FT radius = sqrt(centerX * centerX + centerY * centerY);
+
+  // Verify in blocks, so that the distance computations vectorize, and
+  // failing candidates are rejected early.
+  constexpr size_t BLOCK_SIZE = 64;
+  const Kernel::FT sqTolerance = tolerance * tolerance;
+  for (size_t blockBegin = 0; blockBegin < numPoints;
+       blockBegin += BLOCK_SIZE) {
+    const size_t blockEnd = std::min(blockBegin + BLOCK_SIZE, numPoints);
+    Kernel::FT maxSquaredDist = 0;
+#pragma omp simd reduction(max : maxSquaredDist)
+    for (size_t i = blockBegin; i < blockEnd; ++i) {
+      Kernel::FT dx = xs[i] - centerX;
+      Kernel::FT dy = ys[i] - centerY;
+      Kernel::FT radialDist = sqrt(dx * dx + dy * dy) - radius;
+      Kernel::FT squaredDist = radialDist * radialDist + hs[i] * hs[i];
+      maxSquaredDist = std::max(maxSquaredDist, squaredDist);
+    }
+    if (maxSquaredDist > sqTolerance) {
+      LOG(INFO) << "\t\t\tTolerance exceeded for least squares circle r:"
+                << radius << " by " << sqrt(maxSquaredDist) << std::endl;
+      return noFit;
+    }
+  }
+
+  // The arc is the one on the side of the chord where the points are. The
+  // point furthest off the chord tells the side reliably.
+  const size_t via =
+      std::max_element(ys.begin(), ys.end(),
+                       [](Kernel::FT first, Kernel::FT second) {
+                         return std::abs(first) < std::abs(second);
+                       }) -
+      ys.begin();
+  const Eigen::Vector3d center = origin + centerX * uAxis + centerY * vAxis;
+  LOG(INFO) << "\t\tFit least squares circle r:" << radius << " between "
+            << *begin << " " << *end << std::endl;
+  return std::make_tuple(
+      true, arcThrough(center, normal, *begin, *(begin + 1 + via), *end));
+}
+
+// Fits a line, or else a circular arc, from begin to end, within tolerance of
+// the points in between.
+template <typename PointIter>
+std::tuple<bool, CurvePrimitive_3> findCircleFit(
+    PointIter begin, PointIter end, const Kernel::Plane_3& searchPlane,
+    Kernel::FT tolerance) {
+  // Precondition -- there must be atleast three points for a circle fit.
+  assert(begin + 1 != end);
+
+  Kernel::FT sqTolerance = tolerance * tolerance;
+  // Check if a line works.
+  Kernel::Segment_3 endPointsSegment(*begin, *end);
+  bool fLineValid = true;
+  for (auto iter = begin + 1; iter != end && fLineValid; ++iter) {
+    Kernel::FT squaredDist = CGAL::squared_distance(endPointsSegment, *iter);
+    if (squaredDist > sqTolerance) {
+      fLineValid = false;
+      LOG(INFO) << "\t\t\tTolerance exceeded for line by " << *iter << " "
+                << squaredDist << std::endl;
+    }
+  }
+  if (fLineValid) {
+    LOG(INFO) << "\t\tFit line between " << *begin << " " << *end << std::endl;
+    return std::make_tuple(true, CurvePrimitive_3::line(*begin, *end));
+  }
+
+  // A single least squares candidate usually does.
+  auto leastSquaresFit =
+      fitCircleLeastSquares(begin, end, searchPlane, tolerance);
+  if (std::get<0>(leastSquaresFit)) return leastSquaresFit;
+
+  // Else, fall back to trying fitting incrementally, a circle between begin
+  // and end, passing through a point in between begin and end, and that
+  // satisfies the tolerance criteria.
+  for (auto iter = begin + 1; iter != end; ++iter) {
+    if (CGAL::collinear(*begin, *iter, *end)) continue;
+    Kernel::Circle_3 circleCandidate(*begin, *iter, *end);
+    Kernel::FT circleRadius = sqrt(circleCandidate.squared_radius());
+    bool fCircleValid = true;
+    for (auto inner = begin + 1; inner != end && fCircleValid; ++inner) {
+      Kernel::Point_3 pointCirclePlaneProjection =
+          circleCandidate.supporting_plane().projection(*inner);
+      Kernel::FT squaredDist =
+          CGAL::squared_distance(pointCirclePlaneProjection, *inner) +
+          abs(CGAL::squared_distance(circleCandidate.center(),
+                                     pointCirclePlaneProjection) -
+              circleCandidate.squared_radius());
+      if (squaredDist > sqTolerance) {
+        LOG(INFO) << "\t\t\tTolerance exceeded for circle c:"
+                  << circleCandidate.center() << " r:" << circleRadius
+                  << " by " << *inner << " " << squaredDist << std::endl;
+        fCircleValid = false;
+      }
+    }
+    if (fCircleValid) {
+      LOG(INFO) << "\t\tFit circle c:" << circleCandidate.center()
+                << " r:" << circleRadius << " between " << *begin << " "
+                << *end << std::endl;
+      // We are done searching as we have found 'a' fit -- this may not be
+      // optimal however. TODO msati3: Is this hacky?
+      Kernel::Vector_3 normal =
+          circleCandidate.supporting_plane().orthogonal_vector();
+      return std::make_tuple(
+          true, arcThrough(toEigen(circleCandidate.center()),
+                           Eigen::Vector3d(normal.x(), normal.y(), normal.z())
+                               .normalized(),
+                           *begin, *iter, *end));
+    }
+  }
+  return std::make_tuple(false, CurvePrimitive_3());
+}
+
+}  // namespace circle_fit
+
+#endif  // _FRAMEWORK_GEOMETRY_SIMPLIFICATION_CIRCLE_FIT_H_
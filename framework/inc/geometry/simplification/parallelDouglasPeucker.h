@@ -0,0 +1,175 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_PARALLEL_DOUGLAS_PEUCKER_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_PARALLEL_DOUGLAS_PEUCKER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <psimpl.h>
+
+// Task parallel Douglas-Peucker simplification of a flat array of DIM
+// dimensional coordinates, producing exactly the output of
+// psimpl::simplify_douglas_peucker<DIM> on the same data.
+//
+// As in psimpl, the polyline is first reduced by the (sequential, linear time)
+// radial distance routine, which parallelClassicDouglasPeucker skips, for
+// results within the tolerance. The recursion then runs as OpenMP tasks: a sub
+// polyline of more than grainSize points is split off as a task of its own,
+// while smaller ones are worked off sequentially by the task that found them.
+// The key of a sub polyline is searched for in parallel chunks as well when it
+// is large, so that the top levels of the recursion, which are the ones that
+// dominate on long polylines, do not serialize. The keys of the result are
+// independent of the order in which sub polylines are processed, and ties in
+// the key search are broken as in psimpl (by the last point), and thus, the
+// result does not depend on the scheduling.
+namespace parallel_douglas_peucker {
+
+// The key of a sub polyline: the coordinate index of the point furthest from
+// the segment joining its end points, and the squared distance of that point.
+template <typename T>
+struct KeyInfo {
+  std::ptrdiff_t index;
+  T dist2;
+};
+
+// Same as psimpl's DPHelper::FindKey, over the points with coordinate indexes
+// in [begin, end), for the sub polyline [first, last].
+template <unsigned DIM, typename T>
+KeyInfo<T> findKeyInRange(const T* coords, std::ptrdiff_t first,
+                          std::ptrdiff_t last, std::ptrdiff_t begin,
+                          std::ptrdiff_t end) {
+  KeyInfo<T> keyInfo{0, 0};
+  for (std::ptrdiff_t current = begin; current < end; current += DIM) {
+    T d2 = psimpl::math::segment_distance2<DIM>(coords + first, coords + last,
+                                                coords + current);
+    if (d2 < keyInfo.dist2) continue;
+    keyInfo.index = current;
+    keyInfo.dist2 = d2;
+  }
+  return keyInfo;
+}
+
+template <unsigned DIM, typename T>
+KeyInfo<T> findKey(const T* coords, std::ptrdiff_t first, std::ptrdiff_t last,
+                   std::ptrdiff_t grainSize) {
+  const std::ptrdiff_t numPoints = (last - first) / DIM - 1;
+  if (numPoints <= grainSize) {
+    return findKeyInRange<DIM>(coords, first, last, first + DIM, last);
+  }
+
+  constexpr std::ptrdiff_t MAX_CHUNKS = 64;
+  const std::ptrdiff_t numChunks =
+      std::min<std::ptrdiff_t>(MAX_CHUNKS, numPoints / grainSize);
+  std::vector<KeyInfo<T>> chunkKeys(numChunks);
+  for (std::ptrdiff_t chunk = 0; chunk < numChunks; ++chunk) {
+#pragma omp task shared(chunkKeys) firstprivate(chunk)
+    {
+      std::ptrdiff_t begin = first + DIM * (1 + chunk * numPoints / numChunks);
+      std::ptrdiff_t end =
+          first + DIM * (1 + (chunk + 1) * numPoints / numChunks);
+      chunkKeys[chunk] = findKeyInRange<DIM>(coords, first, last, begin, end);
+    }
+  }
+#pragma omp taskwait
+
+  // Combine in order of the chunks, with the later chunk winning ties, which
+  // is what the sequential search does.
+  KeyInfo<T> keyInfo{0, 0};
+  for (const KeyInfo<T>& chunkKey : chunkKeys) {
+    if (chunkKey.index == 0 || chunkKey.dist2 < keyInfo.dist2) continue;
+    keyInfo = chunkKey;
+  }
+  return keyInfo;
+}
+
+// Marks the keys of the sub polyline [first, last], and of all the sub
+// polylines it splits into.
+template <unsigned DIM, typename T>
+void markKeys(const T* coords, std::ptrdiff_t first, std::ptrdiff_t last,
+              T tol2, std::ptrdiff_t grainSize, unsigned char* keys) {
+  std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>> stack;
+  stack.emplace_back(first, last);
+  while (!stack.empty()) {
+    std::ptrdiff_t subFirst = stack.back().first;
+    std::ptrdiff_t subLast = stack.back().second;
+    stack.pop_back();
+    KeyInfo<T> keyInfo = findKey<DIM>(coords, subFirst, subLast, grainSize);
+    if (!keyInfo.index || !(tol2 < keyInfo.dist2)) continue;
+
+    keys[keyInfo.index / DIM] = 1;
+    const std::ptrdiff_t splits[2][2] = {{subFirst, keyInfo.index},
+                                         {keyInfo.index, subLast}};
+    for (const auto& split : splits) {
+      if ((split[1] - split[0]) / DIM > grainSize) {
+        std::ptrdiff_t splitFirst = split[0], splitLast = split[1];
+#pragma omp task firstprivate(splitFirst, splitLast)
+        markKeys<DIM>(coords, splitFirst, splitLast, tol2, grainSize, keys);
+      } else {
+        stack.emplace_back(split[0], split[1]);
+      }
+    }
+  }
+}
+
+}  // end of namespace parallel_douglas_peucker
+
+// Simplifies the polyline with flat coordinates [coords, coords + coordCount)
+// by classic Douglas-Peucker, without psimpl's radial distance pass, to within
+// tolerance tol, appending the coordinates of the simplified polyline to
+// result. Every dropped point is within tol of the result. Sub polylines of
+// more than grainSize points are processed as tasks of their own.
+template <unsigned DIM, typename T>
+void parallelClassicDouglasPeucker(const T* coords, std::ptrdiff_t coordCount,
+                                   T tol, size_t grainSize,
+                                   std::vector<T>& result) {
+  const std::ptrdiff_t pointCount = coordCount / DIM;
+  // Same input validation as psimpl.
+  if (coordCount % DIM || pointCount < 3 || tol == 0) {
+    result.insert(result.end(), coords, coords + coordCount);
+    return;
+  }
+
+  std::vector<unsigned char> keys(pointCount, 0);
+  keys.front() = 1;
+  keys.back() = 1;
+  const T tol2 = tol * tol;
+  const std::ptrdiff_t grain = std::max<size_t>(grainSize, 1);
+#pragma omp parallel
+#pragma omp single nowait
+  parallel_douglas_peucker::markKeys<DIM>(coords, 0, coordCount - DIM, tol2,
+                                          grain, keys.data());
+
+  for (std::ptrdiff_t point = 0; point < pointCount; ++point) {
+    if (keys[point]) {
+      result.insert(result.end(), coords + point * DIM,
+                    coords + (point + 1) * DIM);
+    }
+  }
+}
+
+// Simplifies the polyline with flat coordinates [first, last) to within
+// tolerance tol, appending the coordinates of the simplified polyline to
+// result. Sub polylines of more than grainSize points are processed as tasks
+// of their own.
+template <unsigned DIM, typename ForwardIterator, typename T>
+void parallelDouglasPeucker(ForwardIterator first, ForwardIterator last, T tol,
+                            size_t grainSize, std::vector<T>& result) {
+  const std::ptrdiff_t coordCount = std::distance(first, last);
+  const std::ptrdiff_t pointCount = coordCount / DIM;
+  // Same input validation as psimpl.
+  if (coordCount % DIM || pointCount < 3 || tol == 0) {
+    result.insert(result.end(), first, last);
+    return;
+  }
+
+  std::vector<T> reduced;
+  reduced.reserve(coordCount);
+  psimpl::simplify_radial_distance<DIM>(first, last, tol,
+                                        std::back_inserter(reduced));
+  parallelClassicDouglasPeucker<DIM>(reduced.data(), reduced.size(), tol,
+                                     grainSize, result);
+}
+
+#endif  //_FRAMEWORK_GEOMETRY_SIMPLIFICATION_PARALLEL_DOUGLAS_PEUCKER_H_
@@ -0,0 +1,44 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_DOUGLAS_PEUCKER_RANKING_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_DOUGLAS_PEUCKER_RANKING_H_
+
+#include <tuple>
+#include <vector>
+
+#include "geometryTypes.h"
+#include "polyline.h"
+
+// Douglas-Peucker importance of the vertices of a polyline, for simplifying
+// the same polyline at many tolerances.
+//
+// The key of each sub polyline visited by Douglas-Peucker does not depend on
+// the tolerance; only whether the recursion goes on does. A vertex is thus
+// kept at tolerance t exactly when its distance to the segment of the sub
+// polyline it is the key of, and that of all the keys the recursion went
+// through to get there, exceed t. The importance of a vertex is the smallest
+// of these distances, and is computed for all vertices in a single run of the
+// recursion down to the last sub polyline. End points have infinite
+// importance.
+//
+// Simplifying at any tolerance is then a linear scan for the vertices more
+// important than the tolerance, and gives exactly the result of classic
+// Douglas-Peucker, without psimpl's radial distance pass: every dropped point
+// is within the tolerance of the result. Results at decreasing tolerances are
+// nested.
+class Polyline_3DouglasPeuckerRanking {
+ public:
+  explicit Polyline_3DouglasPeuckerRanking(
+      const Polyline<Kernel::Point_3>& polyline);
+
+  // Importance of each vertex, in order of the vertices
+  const std::vector<FieldType>& importances() const { return m_importances; }
+
+  // The vertices whose importance exceeds tolerance, and their number.
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      FieldType tolerance) const;
+
+ private:
+  Polyline<Kernel::Point_3> m_polyline;
+  std::vector<FieldType> m_importances;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_DOUGLAS_PEUCKER_RANKING_H_
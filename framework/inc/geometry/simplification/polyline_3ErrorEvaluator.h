@@ -0,0 +1,42 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_ERROR_EVALUATOR_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_ERROR_EVALUATOR_H_
+
+#include "geometryTypes.h"
+#include "polyline.h"
+
+// Deviation between an original polyline and its simplification.
+struct Polyline_3Deviation {
+  // Largest distance from the original to the simplified polyline
+  FieldType maxOriginalToSimplified = 0;
+  // Largest distance from the simplified to the original polyline
+  FieldType maxSimplifiedToOriginal = 0;
+  // Two sided Hausdorff distance, the larger of the above
+  FieldType hausdorff = 0;
+  // Mean distance from the original to the simplified polyline, over its
+  // length
+  FieldType meanDeviation = 0;
+  size_t numSamples = 0;
+};
+
+// Measures the deviation between two polylines by sampling each along its
+// segments, at most sampleSpacing apart, vertices included. Nearest segment
+// queries go through a bounding volume hierarchy over the segments of the
+// other polyline, so the cost is about (n + m) log(n + m) rather than n * m,
+// and samples are processed in parallel.
+//
+// Distance to a polyline changes at most as fast as the sample moves, and
+// thus, the maxima are within sampleSpacing / 2 below the exact ones.
+class Polyline_3ErrorEvaluator {
+ public:
+  explicit Polyline_3ErrorEvaluator(FieldType sampleSpacing)
+      : m_sampleSpacing(sampleSpacing) {}
+
+  Polyline_3Deviation evaluate(const Polyline<Kernel::Point_3>& original,
+                               const Polyline<Kernel::Point_3>& simplified)
+      const;
+
+ private:
+  FieldType m_sampleSpacing;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_ERROR_EVALUATOR_H_
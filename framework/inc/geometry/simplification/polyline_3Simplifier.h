@@ -1,25 +1,171 @@
 #ifndef _POLYLINE_3_SIMPLIFIER_H_
 #define _POLYLINE_3_SIMPLIFIER_H_
 
+#include <tuple>
+#include <type_traits>
+
+#include "biarc_3.h"
 #include "geometryTypes.h"
 #include "polyline.h"
+#include "polyline_3DouglasPeuckerRanking.h"
 
+// Douglas-Peucker, as done by psimpl: a radial distance pass first, and then
+// Douglas-Peucker proper, both with the tolerance. A dropped point is thus
+// within twice the tolerance of the result, not within the tolerance.
 struct Polyline_3SimplificationStrategyDouglasPeucker {};
+// Greedy fit of lines and circular arcs. The polyline result samples the arcs,
+// see simplifyToArcs for the primitives themselves.
 struct Polyline_3SimplificationStrategyNaiveBiarc {};
+// Douglas-Peucker on double precision coordinates, with the recursion split
+// into parallel tasks for sub polylines of more than grainSize points. The
+// result matches the sequential strategy on the same data exactly.
+struct Polyline_3SimplificationStrategyParallelDouglasPeucker {
+  Polyline_3SimplificationStrategyParallelDouglasPeucker(
+      size_t grainSize = 4096)
+      : m_grainSize(grainSize) {}
+  size_t m_grainSize;
+};
+
+// Imai-Iri: the fewest vertices such that every dropped point is within
+// tolerance of the segment that skips it. Quadratic time in the worst case, and
+// meant for curves of up to tens of thousands of points.
+struct Polyline_3SimplificationStrategyImaiIri {};
+
+// Linear time strategies, see psimpl. Radial distance drops the points within
+// tolerance of the last kept point. Reumann-Witkam drops the points within
+// tolerance of the line through the last kept point and its successor.
+struct Polyline_3SimplificationStrategyRadialDistance {};
+struct Polyline_3SimplificationStrategyReumannWitkam {};
+// Opheim is Reumann-Witkam, with the search for points to drop limited to
+// searchDistanceFactor times the tolerance from the last kept point.
+struct Polyline_3SimplificationStrategyOpheim {
+  Polyline_3SimplificationStrategyOpheim(float searchDistanceFactor = 10)
+      : m_searchDistanceFactor(searchDistanceFactor) {}
+  float m_searchDistanceFactor;
+};
+// Lang drops the points within tolerance of the segments that span up to
+// lookAhead points.
+struct Polyline_3SimplificationStrategyLang {
+  Polyline_3SimplificationStrategyLang(unsigned lookAhead = 8)
+      : m_lookAhead(lookAhead) {}
+  unsigned m_lookAhead;
+};
+
+// Whether Strategy bounds the distance of every point of its input to its
+// result by its tolerance. Reumann-Witkam and Opheim bound the distance to the
+// lines through the kept points only, which does not bound the distance to
+// the segments between them.
+template <typename Strategy>
+struct Polyline_3SimplificationStrategyIsBounded : std::true_type {};
+template <>
+struct Polyline_3SimplificationStrategyIsBounded<
+    Polyline_3SimplificationStrategyReumannWitkam> : std::false_type {};
+template <>
+struct Polyline_3SimplificationStrategyIsBounded<
+    Polyline_3SimplificationStrategyOpheim> : std::false_type {};
+
+// Radial distance prefilter, followed by Strategy, for densely sampled
+// polylines. The prefilter runs with prefilterFraction of the tolerance, and
+// Strategy with the rest of it. Every dropped point is within the prefilter
+// tolerance of a prefiltered point, and thus, within the whole tolerance of
+// the result, as Strategy bounds the distance of the prefiltered points to its
+// result by its tolerance. Strategies that do not are rejected.
+//
+// The Douglas-Peucker strategies do not either, as psimpl runs a radial
+// distance pass of its own ahead of them (see above). Within a cascade, they
+// run as classic Douglas-Peucker instead, see Polyline_3DouglasPeuckerRanking
+// and parallelClassicDouglasPeucker.
+template <typename Strategy>
+struct Polyline_3SimplificationStrategyCascade {
+  static_assert(Polyline_3SimplificationStrategyIsBounded<Strategy>::value,
+                "The cascade needs a strategy that bounds the distance of the "
+                "points it drops by its tolerance");
+
+  Polyline_3SimplificationStrategyCascade(
+      const Strategy& strategy = Strategy(), float prefilterFraction = 0.25)
+      : m_strategy(strategy), m_prefilterFraction(prefilterFraction) {}
+  Strategy m_strategy;
+  float m_prefilterFraction;
+};
 
 class Polyline_3Simplifier {
  public:
+  static constexpr float ARC_SAMPLING_TOLERANCE = 0.1f;
+
   Polyline_3Simplifier(float tolerance) : m_tolerance(tolerance) {}
 
   std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
       const Polyline<Kernel::Point_3>& polyline,
       const Polyline_3SimplificationStrategyDouglasPeucker&);
 
+  // The arcs are sampled with chords within ARC_SAMPLING_TOLERANCE times the
+  // tolerance of them.
   std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyNaiveBiarc& strategy);
+
+  // The lines and arcs fitted, one primitive each.
+  std::tuple<size_t, Biarc_3> simplifyToArcs(
       const Polyline<Kernel::Point_3>& polyline,
       const Polyline_3SimplificationStrategyNaiveBiarc&);
 
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyParallelDouglasPeucker& strategy);
+
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyRadialDistance&);
+
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyReumannWitkam&);
+
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyOpheim& strategy);
+
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyLang& strategy);
+
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyImaiIri&);
+
+  template <typename Strategy>
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplify(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyCascade<Strategy>& strategy) {
+    const float prefilterTolerance =
+        strategy.m_prefilterFraction * m_tolerance;
+    Polyline_3Simplifier simplifier(m_tolerance - prefilterTolerance);
+    return simplifier.simplifyWithinTolerance(
+        prefilterRadialDistance(polyline, prefilterTolerance),
+        strategy.m_strategy);
+  }
+
  private:
+  // Same as simplify, but for the Douglas-Peucker strategies, which run
+  // without psimpl's radial distance pass, so as to keep every dropped point
+  // within the tolerance.
+  template <typename Strategy>
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplifyWithinTolerance(
+      const Polyline<Kernel::Point_3>& polyline, const Strategy& strategy) {
+    return simplify(polyline, strategy);
+  }
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplifyWithinTolerance(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyDouglasPeucker&) {
+    return Polyline_3DouglasPeuckerRanking(polyline).simplify(m_tolerance);
+  }
+  std::tuple<size_t, Polyline<Kernel::Point_3>> simplifyWithinTolerance(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SimplificationStrategyParallelDouglasPeucker& strategy);
+
+  static Polyline<Kernel::Point_3> prefilterRadialDistance(
+      const Polyline<Kernel::Point_3>& polyline, FieldType tolerance);
+
   float m_tolerance;
 };
 
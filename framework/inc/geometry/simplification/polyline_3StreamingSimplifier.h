@@ -0,0 +1,51 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_STREAMING_SIMPLIFIER_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_STREAMING_SIMPLIFIER_H_
+
+#include <functional>
+#include <vector>
+
+#include "geometryTypes.h"
+
+// Online simplification of a polyline that arrives one point at a time, for
+// point streams that cannot be buffered whole.
+//
+// The simplifier keeps an open window of the points since the last emitted
+// vertex (the anchor). A new point extends the window as long as every point
+// of the window stays within tolerance of the segment from the anchor to the
+// new point. Once it does not, the last point of the window is final: it is
+// emitted, and becomes the new anchor. Each dropped point is thus within
+// tolerance of the segment it was tested against, the same bound as
+// Douglas-Peucker.
+//
+// Memory and per point work are bounded by maxWindowSize: a window that
+// fills up is closed as if the next point did not fit. Vertices are emitted
+// as soon as the first point that does not fit arrives.
+class Polyline_3StreamingSimplifier {
+ public:
+  using VertexSink = std::function<void(const Kernel::Point_3&)>;
+
+  Polyline_3StreamingSimplifier(FieldType tolerance, VertexSink sink,
+                                size_t maxWindowSize = 256);
+
+  void addPoint(const Kernel::Point_3& point);
+
+  // Emits the last point of the stream. The simplifier can then be reused for
+  // another stream.
+  void finish();
+
+  // Number of points pending in the window
+  size_t windowSize() const { return m_window.size(); }
+
+ private:
+  bool fitsWindow(const Kernel::Point_3& point) const;
+  void emit(const Kernel::Point_3& point);
+
+  FieldType m_squaredTolerance;
+  VertexSink m_sink;
+  size_t m_maxWindowSize;
+  bool m_hasAnchor;
+  Kernel::Point_3 m_anchor;
+  std::vector<Kernel::Point_3> m_window;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_SIMPLIFICATION_POLYLINE_3_STREAMING_SIMPLIFIER_H_
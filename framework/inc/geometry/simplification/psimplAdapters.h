@@ -0,0 +1,154 @@
+#ifndef _FRAMEWORK_GEOMETRY_SIMPLIFICATION_PSIMPL_ADAPTERS_H_
+#define _FRAMEWORK_GEOMETRY_SIMPLIFICATION_PSIMPL_ADAPTERS_H_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "geometryTypes.h"
+
+// Adapters to run psimpl's simplification routines directly on ranges of
+// points, without unrolling them to flat coordinate arrays first.
+
+// Random access iterator over the coordinates of a range of 3D points: x, y
+// and z of the first point, then those of the next point, and so on, in full
+// (FieldType) precision. Coordinates are read straight off the points.
+template <typename PointIterator>
+class FlatCoordinateIterator
+    : public boost::iterator_facade<FlatCoordinateIterator<PointIterator>,
+                                    FieldType, std::random_access_iterator_tag,
+                                    FieldType> {
+ public:
+  static constexpr int DIM = 3;
+
+  FlatCoordinateIterator() : m_coordIndex(0) {}
+  FlatCoordinateIterator(PointIterator points, std::ptrdiff_t coordIndex)
+      : m_points(points), m_coordIndex(coordIndex) {}
+
+  // Iterators to the coordinates of the range of points [first, last).
+  static FlatCoordinateIterator begin(PointIterator first) {
+    return FlatCoordinateIterator(first, 0);
+  }
+  static FlatCoordinateIterator end(PointIterator first, PointIterator last) {
+    return FlatCoordinateIterator(first, DIM * std::distance(first, last));
+  }
+
+ private:
+  friend class boost::iterator_core_access;
+
+  void increment() { ++m_coordIndex; }
+  void decrement() { --m_coordIndex; }
+  void advance(std::ptrdiff_t n) { m_coordIndex += n; }
+
+  std::ptrdiff_t distance_to(const FlatCoordinateIterator& other) const {
+    return other.m_coordIndex - m_coordIndex;
+  }
+
+  bool equal(const FlatCoordinateIterator& other) const {
+    return m_coordIndex == other.m_coordIndex && m_points == other.m_points;
+  }
+
+  FieldType dereference() const {
+    return m_points[m_coordIndex / DIM][m_coordIndex % DIM];
+  }
+
+  PointIterator m_points;
+  std::ptrdiff_t m_coordIndex;
+};
+
+// Collects the indexes of the points that psimpl keeps, instead of their
+// coordinates. psimpl writes out the coordinates of the kept points in order,
+// as exact copies of the input coordinates, and thus, the index of each kept
+// point is found by scanning forward through the input -- linear time over
+// the whole simplification. The simplified polyline can then be gathered from
+// the input points.
+template <typename PointIterator>
+class KeyIndexCollector {
+ public:
+  static constexpr int DIM = 3;
+
+  KeyIndexCollector(PointIterator first, PointIterator last)
+      : m_first(first), m_last(last), m_cursor(first), m_numCoords(0) {}
+
+  // Output iterator of coordinates, to pass to psimpl. Copies of the iterator
+  // refer to the same collector.
+  class OutputIterator {
+   public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = void;
+    using pointer = void;
+    using reference = void;
+
+    explicit OutputIterator(KeyIndexCollector* collector)
+        : m_collector(collector) {}
+
+    OutputIterator& operator*() { return *this; }
+    OutputIterator& operator++() { return *this; }
+    OutputIterator& operator++(int) { return *this; }
+    OutputIterator& operator=(FieldType coordinate) {
+      m_collector->addCoordinate(coordinate);
+      return *this;
+    }
+
+   private:
+    KeyIndexCollector* m_collector;
+  };
+
+  OutputIterator outputIterator() { return OutputIterator(this); }
+
+  // Indexes of the kept points, in increasing order
+  const std::vector<size_t>& indices() const { return m_indices; }
+
+ private:
+  void addCoordinate(FieldType coordinate) {
+    m_coords[m_numCoords++] = coordinate;
+    if (m_numCoords < DIM) return;
+    m_numCoords = 0;
+    while (m_cursor != m_last && !matches(*m_cursor)) ++m_cursor;
+    if (m_cursor == m_last) return;
+    m_indices.push_back(std::distance(m_first, m_cursor));
+    ++m_cursor;
+  }
+
+  template <typename Point>
+  bool matches(const Point& point) const {
+    for (int d = 0; d < DIM; ++d) {
+      if (point[d] != m_coords[d]) return false;
+    }
+    return true;
+  }
+
+  PointIterator m_first;
+  PointIterator m_last;
+  PointIterator m_cursor;
+  FieldType m_coords[DIM];
+  int m_numCoords;
+  std::vector<size_t> m_indices;
+};
+
+// Runs a psimpl routine over the points of polyline, and gathers the points it
+// keeps. simplify is called with the begin and end coordinate iterators, and
+// the output iterator to pass to the routine.
+template <typename PolylineType, typename Simplify>
+PolylineType simplifyWithPsimpl(const PolylineType& polyline,
+                                Simplify simplify) {
+  using PointIterator = typename PolylineType::const_iterator;
+  using CoordinateIterator = FlatCoordinateIterator<PointIterator>;
+  KeyIndexCollector<PointIterator> keyIndices(polyline.begin(),
+                                              polyline.end());
+  simplify(CoordinateIterator::begin(polyline.begin()),
+           CoordinateIterator::end(polyline.begin(), polyline.end()),
+           keyIndices.outputIterator());
+
+  PolylineType simplified;
+  simplified.reserve(keyIndices.indices().size());
+  for (size_t index : keyIndices.indices()) {
+    simplified.addPoint(*(polyline.begin() + index));
+  }
+  return simplified;
+}
+
+#endif  //_FRAMEWORK_GEOMETRY_SIMPLIFICATION_PSIMPL_ADAPTERS_H_
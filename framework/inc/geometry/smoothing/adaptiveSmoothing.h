@@ -0,0 +1,226 @@
+#ifndef _FRAMEWORK_GEOMETRY_SMOOTHING_ADAPTIVE_SMOOTHING_H_
+#define _FRAMEWORK_GEOMETRY_SMOOTHING_ADAPTIVE_SMOOTHING_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "geometryTypes.h"
+#include "laplacianSmoothing.h"
+#include "polyline.h"
+
+// Localized smoothing of 3D polylines with flat coordinates, for curves that
+// are mostly clean, with noise in a few places only.
+//
+// The discrete curvature vector of each interior point, that is, the change
+// of the unit tangent over the point, divided by the length of the polyline
+// around it, is computed once. Along smooth stretches, it changes slowly; its
+// noise is its deviation from its average over curvatureHalfWidth points on
+// either side. Points whose curvature noise exceeds noiseThreshold are marked,
+// and are smoothed within a window of windowMargin points on either side, with
+// overlapping windows merged. Each window is smoothed as a polyline of its
+// own, by the iterations of laplacianSmoothing, with the ends of the window
+// kept fixed, as are the ends of the polyline. Points outside the windows are
+// left untouched.
+namespace adaptive_smoothing {
+
+using Vector3 = std::array<double, 3>;
+
+template <typename T>
+Vector3 difference(const T* a, const T* b) {
+  return {{a[0] - b[0], a[1] - b[1], a[2] - b[2]}};
+}
+
+inline double norm(const Vector3& v) {
+  return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+inline Vector3 cross(const Vector3& a, const Vector3& b) {
+  return {{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+           a[0] * b[1] - a[1] * b[0]}};
+}
+
+// Curvature noise of each point, 0 at the ends.
+template <typename T>
+std::vector<double> curvatureNoise(const T* coords, size_t numPoints,
+                                   size_t curvatureHalfWidth) {
+  std::vector<double> noise(numPoints, 0);
+  if (numPoints < 3) return noise;
+
+  // Curvature vectors, and their prefix sums for the averages.
+  std::vector<Vector3> curvature(numPoints, Vector3{{0, 0, 0}});
+  std::vector<Vector3> prefix(numPoints + 1, Vector3{{0, 0, 0}});
+  for (size_t point = 1; point + 1 < numPoints; ++point) {
+    const T* current = coords + 3 * point;
+    Vector3 before = difference(current, current - 3);
+    Vector3 after = difference(current + 3, current);
+    const double lengthBefore = norm(before);
+    const double lengthAfter = norm(after);
+    if (lengthBefore > 0 && lengthAfter > 0) {
+      const double scale = 2 / (lengthBefore + lengthAfter);
+      for (size_t d = 0; d < 3; ++d) {
+        curvature[point][d] =
+            scale * (after[d] / lengthAfter - before[d] / lengthBefore);
+      }
+    }
+  }
+  for (size_t point = 0; point < numPoints; ++point) {
+    for (size_t d = 0; d < 3; ++d) {
+      prefix[point + 1][d] = prefix[point][d] + curvature[point][d];
+    }
+  }
+
+  for (size_t point = 1; point + 1 < numPoints; ++point) {
+    const size_t first = std::max<size_t>(point, curvatureHalfWidth + 1) -
+                         curvatureHalfWidth;
+    const size_t last = std::min(point + curvatureHalfWidth, numPoints - 2);
+    Vector3 deviation;
+    for (size_t d = 0; d < 3; ++d) {
+      const double average =
+          (prefix[last + 1][d] - prefix[first][d]) / (last - first + 1);
+      deviation[d] = curvature[point][d] - average;
+    }
+    noise[point] = norm(deviation);
+  }
+  return noise;
+}
+
+// Windows [first, last] of point indexes around the noisy points, disjoint
+// but for possibly sharing an end, in order.
+inline std::vector<std::pair<size_t, size_t>> noisyWindows(
+    const std::vector<double>& noise, double noiseThreshold,
+    size_t windowMargin) {
+  std::vector<std::pair<size_t, size_t>> windows;
+  const size_t numPoints = noise.size();
+  for (size_t point = 0; point < numPoints; ++point) {
+    if (!(noise[point] > noiseThreshold)) continue;
+    const size_t first = point - std::min(point, windowMargin);
+    const size_t last = std::min(point + windowMargin, numPoints - 1);
+    if (!windows.empty() && first < windows.back().second) {
+      windows.back().second = last;
+    } else {
+      windows.emplace_back(first, last);
+    }
+  }
+  return windows;
+}
+
+// Twice the vector area enclosed by the points [first, last] of the polyline,
+// closed by the chord from the last point back to the first.
+template <typename T>
+Vector3 windowArea(const T* coords, size_t first, size_t last) {
+  Vector3 area{{0, 0, 0}};
+  const T* origin = coords + 3 * first;
+  for (size_t point = first + 1; point < last; ++point) {
+    Vector3 edgeArea = cross(difference(coords + 3 * point, origin),
+                             difference(coords + 3 * (point + 1), origin));
+    for (size_t d = 0; d < 3; ++d) area[d] += edgeArea[d];
+  }
+  return area;
+}
+
+// Restores the area of the window [first, last] after smoothing, by scaling
+// the offsets of its points from the chord of the window by the ratio of the
+// areas. This is exact for planar windows.
+//
+// Smoothing shrinks the smooth shape of the window, but also removes the
+// noise, and the area of the noise is no shape to restore. The scale is thus
+// capped by the shrinkage of the smoothest shape the window can take (its
+// lowest Laplacian eigenmode), which no shape shrinks beyond.
+template <typename T>
+void restoreArea(T* coords, size_t first, size_t last,
+                 const Vector3& originalArea, T stepSize,
+                 size_t numIterations) {
+  const double original = norm(originalArea);
+  const double smoothed = norm(windowArea(coords, first, last));
+  const T* start = coords + 3 * first;
+  Vector3 chord = difference(coords + 3 * last, start);
+  const double chordLength = norm(chord);
+  if (original == 0 || smoothed == 0 || chordLength == 0) return;
+
+  const double pi = std::acos(-1.0);
+  const double eigenvalue = 2 - 2 * std::cos(pi / (last - first));
+  const double modeResponse = std::pow(
+      (1 - stepSize * eigenvalue) * (1 + 0.5 * stepSize * eigenvalue),
+      numIterations);
+  if (!(modeResponse > 0)) return;
+  const double scale =
+      std::min(std::max(original / smoothed, 1.0), 1 / modeResponse);
+
+  for (size_t d = 0; d < 3; ++d) chord[d] /= chordLength;
+  for (size_t point = first + 1; point < last; ++point) {
+    T* current = coords + 3 * point;
+    Vector3 offset = difference(current, start);
+    const double along =
+        offset[0] * chord[0] + offset[1] * chord[1] + offset[2] * chord[2];
+    for (size_t d = 0; d < 3; ++d) {
+      const double onChord = start[d] + along * chord[d];
+      current[d] = onChord + scale * (current[d] - onChord);
+    }
+  }
+}
+
+}  // end of namespace adaptive_smoothing
+
+// Smooths the noisy windows of the polyline with flat 3D coordinates coords,
+// in place, and restores their area (see adaptive_smoothing::restoreArea).
+// Windows are independent of one another, and are smoothed in parallel.
+// Returns the number of points smoothed.
+template <typename T>
+size_t curvatureAdaptiveSmoothing(T* coords, size_t numPoints, T stepSize,
+                                  size_t numIterations, T noiseThreshold,
+                                  size_t windowMargin,
+                                  size_t curvatureHalfWidth) {
+  using namespace adaptive_smoothing;
+  const std::vector<std::pair<size_t, size_t>> windows = noisyWindows(
+      curvatureNoise(coords, numPoints, curvatureHalfWidth), noiseThreshold,
+      windowMargin);
+
+  size_t numSmoothed = 0;
+  const long numWindows = windows.size();
+#pragma omp parallel for schedule(dynamic, 1) reduction(+ : numSmoothed)
+  for (long window = 0; window < numWindows; ++window) {
+    const size_t first = windows[window].first;
+    const size_t last = windows[window].second;
+    if (last - first < 2) continue;
+    const Vector3 area = windowArea(coords, first, last);
+    laplacianSmoothing<3>(coords + 3 * first, last - first + 1, stepSize,
+                          numIterations);
+    restoreArea(coords, first, last, area, stepSize, numIterations);
+    numSmoothed += last - first - 1;
+  }
+  return numSmoothed;
+}
+
+// Runs on double precision coordinates, so that the points outside the
+// windows are returned exactly as they are.
+template <typename PointType>
+Polyline<PointType> curvatureAdaptiveSmoothing(
+    const Polyline<PointType>& polyline, float stepSize, size_t numIterations,
+    FieldType noiseThreshold, size_t windowMargin,
+    size_t curvatureHalfWidth) {
+  std::vector<FieldType> unrolledPolyline;
+  unrolledPolyline.reserve(3 * polyline.size());
+  for (const PointType& point : polyline) {
+    unrolledPolyline.push_back(point.x());
+    unrolledPolyline.push_back(point.y());
+    unrolledPolyline.push_back(point.z());
+  }
+
+  curvatureAdaptiveSmoothing(unrolledPolyline.data(), polyline.size(),
+                             FieldType(stepSize), numIterations, noiseThreshold,
+                             windowMargin, curvatureHalfWidth);
+
+  Polyline<PointType> smoothed;
+  smoothed.reserve(polyline.size());
+  for (auto coord = unrolledPolyline.begin(); coord != unrolledPolyline.end();
+       coord += 3) {
+    smoothed.addPoint(PointType(coord[0], coord[1], coord[2]));
+  }
+  return smoothed;
+}
+
+#endif  // _FRAMEWORK_GEOMETRY_SMOOTHING_ADAPTIVE_SMOOTHING_H_
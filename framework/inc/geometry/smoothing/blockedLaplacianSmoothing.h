@@ -0,0 +1,111 @@
+#ifndef _FRAMEWORK_GEOMETRY_SMOOTHING_BLOCKED_LAPLACIAN_SMOOTHING_H_
+#define _FRAMEWORK_GEOMETRY_SMOOTHING_BLOCKED_LAPLACIAN_SMOOTHING_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Cache blocked version of laplacianSmoothing<DIM> (see laplacianSmoothing.h),
+// bit for bit equal to it, on structure of arrays coordinates: coords[d] is
+// the array of the d-th coordinates of the numPoints points.
+//
+// Plain iterations stream the whole polyline through memory twice per
+// iteration. Here, the polyline is cut into tiles of tileSize points, and
+// iterationsPerTile iterations are run on each tile while it is in cache,
+// before moving on to the next tile. A tile is extended by a halo of two
+// points per iteration on each side, as each half step (towards, then away
+// from the neighbour average) spreads the dependency on the neighbours by one
+// point. The halo points are stale by the end of the iterations, and only the
+// tile proper is written back. Tiles are independent of one another, and are
+// processed in parallel, reading from one copy of the coordinates and writing
+// to another.
+//
+// Within a tile, each half step is a vectorizable loop over contiguous
+// coordinates. Every point is updated with the same operations, in the same
+// order, as by laplaceStep, and thus, to the same values.
+template <unsigned DIM, typename T>
+void blockedLaplacianSmoothing(T* const* coords, size_t numPoints, T stepSize,
+                               size_t numIterations, size_t tileSize = 4096,
+                               size_t iterationsPerTile = 16) {
+  if (numPoints < 3 || numIterations == 0) return;
+  tileSize = std::max<size_t>(tileSize, 1);
+  iterationsPerTile = std::max<size_t>(iterationsPerTile, 1);
+  const size_t halo = 2 * iterationsPerTile;
+  const size_t tileStride = tileSize + 2 * halo;
+  const long numTiles = (numPoints + tileSize - 1) / tileSize;
+  const size_t numBlocks =
+      (numIterations + iterationsPerTile - 1) / iterationsPerTile;
+  const T factors[2] = {stepSize, T(-0.5) * stepSize};
+
+  std::vector<T> copy(DIM * numPoints);
+#pragma omp parallel
+  {
+    // Every thread swaps its own pointers to the two copies, in step.
+    T* source[DIM];
+    T* target[DIM];
+    for (unsigned d = 0; d < DIM; ++d) {
+      source[d] = coords[d];
+      target[d] = copy.data() + d * numPoints;
+    }
+    // Two buffers per coordinate, for the half steps to alternate between.
+    std::vector<T> tileBuffers(2 * DIM * tileStride);
+
+    for (size_t block = 0; block < numBlocks; ++block) {
+      const size_t blockIterations = std::min(
+          iterationsPerTile, numIterations - block * iterationsPerTile);
+#pragma omp for schedule(static)
+      for (long tile = 0; tile < numTiles; ++tile) {
+        const size_t coreBegin = tile * tileSize;
+        const size_t coreEnd = std::min(coreBegin + tileSize, numPoints);
+        const size_t begin = coreBegin - std::min(coreBegin, halo);
+        const size_t end = std::min(coreEnd + halo, numPoints);
+        const long size = end - begin;
+
+        T* in[DIM];
+        T* out[DIM];
+        for (unsigned d = 0; d < DIM; ++d) {
+          in[d] = tileBuffers.data() + 2 * d * tileStride;
+          out[d] = in[d] + tileStride;
+          std::copy(source[d] + begin, source[d] + end, in[d]);
+          // The first and last points of the tile are never updated: either
+          // they are the fixed ends of the polyline, or they are halo.
+          out[d][0] = in[d][0];
+          out[d][size - 1] = in[d][size - 1];
+        }
+
+        for (size_t step = 0; step < 2 * blockIterations; ++step) {
+          const T factor = factors[step % 2];
+          for (unsigned d = 0; d < DIM; ++d) {
+            const T* previous = in[d];
+            T* next = out[d];
+#pragma omp simd
+            for (long point = 1; point < size - 1; ++point) {
+              next[point] =
+                  previous[point] +
+                  factor * (previous[point - 1] - 2 * previous[point] +
+                            previous[point + 1]);
+            }
+            std::swap(in[d], out[d]);
+          }
+        }
+
+        for (unsigned d = 0; d < DIM; ++d) {
+          std::copy(in[d] + (coreBegin - begin), in[d] + (coreEnd - begin),
+                    target[d] + coreBegin);
+        }
+      }
+      // The implicit barrier of the loop above ends the block.
+      for (unsigned d = 0; d < DIM; ++d) std::swap(source[d], target[d]);
+    }
+  }
+
+  // After an odd number of blocks, the result is in the copy.
+  if (numBlocks % 2) {
+    for (unsigned d = 0; d < DIM; ++d) {
+      std::copy(copy.data() + d * numPoints, copy.data() + (d + 1) * numPoints,
+                coords[d]);
+    }
+  }
+}
+
+#endif  // _FRAMEWORK_GEOMETRY_SMOOTHING_BLOCKED_LAPLACIAN_SMOOTHING_H_
@@ -0,0 +1,139 @@
+#ifndef _FRAMEWORK_GEOMETRY_SMOOTHING_IMPLICIT_SMOOTHING_H_
+#define _FRAMEWORK_GEOMETRY_SMOOTHING_IMPLICIT_SMOOTHING_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "geometryTypes.h"
+
+// Backward Euler (implicit) Laplacian smoothing: solves (I - lambda L) x = x0
+// for the smoothed coordinates x, given the coordinates x0, where L is the
+// discrete Laplacian, p[i - 1] - 2 p[i] + p[i + 1]. The system is tridiagonal,
+// and diagonally dominant for any lambda >= 0, and thus, is solved directly,
+// without pivoting, in linear time. Unlike explicit steps, which blow up
+// beyond a step size of 1/2, a solve is stable for any lambda: a large lambda
+// smooths as far as many small steps.
+//
+// Coordinates are flat: numPoints points of DIM coordinates each, solved in
+// place. All DIM coordinates share the matrix, and thus, the elimination.
+
+// Open polylines, with the ends kept fixed. Thomas algorithm.
+template <unsigned DIM, typename T>
+void implicitLaplaceStep(T* coords, size_t numPoints, T lambda) {
+  if (numPoints < 3) return;
+  const T diagonal = 1 + 2 * lambda;
+  // Forward elimination. The upper diagonal of each eliminated row, scaled to
+  // a unit diagonal; the first row is that of the fixed end, an identity row.
+  std::vector<T> upper(numPoints - 1);
+  upper[0] = 0;
+  for (size_t point = 1; point + 1 < numPoints; ++point) {
+    const T scale = 1 / (diagonal + lambda * upper[point - 1]);
+    upper[point] = -lambda * scale;
+    T* current = coords + point * DIM;
+    const T* previous = current - DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      current[d] = (current[d] + lambda * previous[d]) * scale;
+    }
+  }
+  // Back substitution, from the other fixed end.
+  for (size_t point = numPoints - 2; point > 0; --point) {
+    T* current = coords + point * DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      current[d] -= upper[point] * current[d + DIM];
+    }
+  }
+}
+
+// Closed polylines, where the last point neighbours the first. The corner
+// entries of the cyclic matrix are split off as a rank one correction
+// (Sherman-Morrison), leaving two tridiagonal solves: one of the coordinates,
+// and one of the correction vector.
+template <unsigned DIM, typename T>
+void implicitLaplaceStepCyclic(T* coords, size_t numPoints, T lambda) {
+  if (numPoints < 3 || lambda == 0) return;
+  const T diagonal = 1 + 2 * lambda;
+  const T corner = -lambda;
+  // The cyclic matrix is A + u v^T, with u = (gamma, 0, ..., 0, corner) and
+  // v = (1, 0, ..., 0, corner / gamma), and A tridiagonal.
+  const T gamma = -diagonal;
+  std::vector<T> mainDiagonal(numPoints, diagonal);
+  mainDiagonal.front() = diagonal - gamma;
+  mainDiagonal.back() = diagonal - corner * corner / gamma;
+
+  // Forward elimination of A, applied to the coordinates and to u alike.
+  std::vector<T> upper(numPoints);
+  std::vector<T> correction(numPoints, 0);
+  correction.front() = gamma;
+  correction.back() = corner;
+  T scale = 1 / mainDiagonal[0];
+  upper[0] = -lambda * scale;
+  correction[0] *= scale;
+  for (unsigned d = 0; d < DIM; ++d) coords[d] *= scale;
+  for (size_t point = 1; point < numPoints; ++point) {
+    scale = 1 / (mainDiagonal[point] + lambda * upper[point - 1]);
+    upper[point] = -lambda * scale;
+    correction[point] =
+        (correction[point] + lambda * correction[point - 1]) * scale;
+    T* current = coords + point * DIM;
+    const T* previous = current - DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      current[d] = (current[d] + lambda * previous[d]) * scale;
+    }
+  }
+  for (size_t point = numPoints - 1; point-- > 0;) {
+    correction[point] -= upper[point] * correction[point + 1];
+    T* current = coords + point * DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      current[d] -= upper[point] * current[d + DIM];
+    }
+  }
+
+  // x = y - z (v^T y) / (1 + v^T z), with A y = x0 and A z = u.
+  const T* last = coords + (numPoints - 1) * DIM;
+  const T denominator =
+      1 + correction.front() + corner * correction.back() / gamma;
+  T factors[DIM];
+  for (unsigned d = 0; d < DIM; ++d) {
+    factors[d] = (coords[d] + corner * last[d] / gamma) / denominator;
+  }
+  for (size_t point = 0; point < numPoints; ++point) {
+    T* current = coords + point * DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      current[d] -= correction[point] * factors[d];
+    }
+  }
+}
+
+// numSolves backward Euler steps of lambda each, on the points of a Polyline
+// (open) or a Polyloop_3 (closed), in double precision.
+template <typename PolylineType>
+PolylineType implicitSmoothing(const PolylineType& polyline, FieldType lambda,
+                               size_t numSolves, bool closed) {
+  using PointType = typename PolylineType::value_type;
+  std::vector<FieldType> unrolledPolyline;
+  unrolledPolyline.reserve(3 * polyline.size());
+  for (const PointType& point : polyline) {
+    unrolledPolyline.push_back(point.x());
+    unrolledPolyline.push_back(point.y());
+    unrolledPolyline.push_back(point.z());
+  }
+
+  for (size_t solve = 0; solve < numSolves; ++solve) {
+    if (closed) {
+      implicitLaplaceStepCyclic<3>(unrolledPolyline.data(), polyline.size(),
+                                   lambda);
+    } else {
+      implicitLaplaceStep<3>(unrolledPolyline.data(), polyline.size(),
+                             lambda);
+    }
+  }
+
+  PolylineType smoothed;
+  for (auto coord = unrolledPolyline.begin(); coord != unrolledPolyline.end();
+       coord += 3) {
+    smoothed.addPoint(PointType(coord[0], coord[1], coord[2]));
+  }
+  return smoothed;
+}
+
+#endif  // _FRAMEWORK_GEOMETRY_SMOOTHING_IMPLICIT_SMOOTHING_H_
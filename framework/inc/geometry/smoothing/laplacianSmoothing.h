@@ -1,65 +1,81 @@
 #ifndef _FRAMEWORK_GEOMETRY_SMOOTHING_LAPLACIAN_SMOOTHING_H_
 #define _FRAMEWORK_GEOMETRY_SMOOTHING_LAPLACIAN_SMOOTHING_H_
 
-#include <Eigen/Core>
+#include <cstddef>
+#include <vector>
 
+#include "blockedLaplacianSmoothing.h"
 #include "polyline.h"
-#include "polylineGeometryProvider.h"
-#include "defaultBufferProviders.h"
 
-template <typename PointType>
-Polyline<PointType> laplacianSmoothing(const Polyline<PointType>& polyline,
-                                       float stepSize, size_t numIterations) {
-  Eigen::MatrixXf laplacian =
-      Eigen::MatrixXf::Zero(polyline.size(), polyline.size());
-
-  // Populate a single row of the laplace matrix by using an adjacency stencil
-  auto laplaceStencilFill = [&laplacian](int index) {
-    // Keep ends fixed.
-    if (index > 0 && index < laplacian.cols() - 1) {
-      laplacian.row(index)[index] = -2;
-      laplacian.row(index)[index - 1] = 1;
-      laplacian.row(index)[index + 1] = 1;
+// Adds factor times the discrete Laplacian, p[i - 1] - 2 p[i] + p[i + 1], to
+// each point of the polyline with flat coordinates coords, of numPoints points
+// of DIM coordinates each, in place. Ends are kept fixed.
+//
+// The Laplacian is that of the polyline before the step, as for a product with
+// the tridiagonal Laplace matrix: the old coordinates of the previous point
+// are carried along, so the step needs no copy of the polyline. The result is
+// that of the product up to rounding only: a dense product sums the terms of
+// each row in the order of its blocking, and scales them by factor on the
+// way, so the two differ in the last bits of some of the coordinates.
+template <unsigned DIM, typename T>
+void laplaceStep(T* coords, size_t numPoints, T factor) {
+  if (numPoints < 3) return;
+  T previous[DIM];
+  for (unsigned d = 0; d < DIM; ++d) previous[d] = coords[d];
+  for (size_t point = 1; point + 1 < numPoints; ++point) {
+    T* current = coords + point * DIM;
+    for (unsigned d = 0; d < DIM; ++d) {
+      const T old = current[d];
+      current[d] = old + factor * (previous[d] - 2 * old + current[d + DIM]);
+      previous[d] = old;
     }
-  };
-
-  for (size_t i = 0; i < polyline.size(); ++i) {
-    laplaceStencilFill(i);
   }
+}
 
-  using GeometryProvider =
-      PolylineGeometryProvider<Polyline<PointType>, PolylinePointPolicy>;
-  using GeometryAdaptor =
-      SingleElementProviderAdaptor<GeometryProvider, PositionVertexElement>;
-  VertexElementBufferProvider<GeometryAdaptor, PositionVertexElement>
-      flatIterProvider{GeometryProvider(polyline)};
-
-  std::vector<float> unrolledPolyline;
-  unrolledPolyline.insert(unrolledPolyline.begin(), flatIterProvider.begin(),
-                          flatIterProvider.end());
-
-  Eigen::Map<
-      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
-      polylineMatrix(unrolledPolyline.data(), polyline.size(), 3);
-
-  for (int i = 0; i < numIterations; ++i) {
+// Taubin style smoothing of the polyline with flat coordinates coords, in
+// place: each iteration moves the points towards the average of their
+// neighbours by stepSize, and back away from it by half of stepSize, which
+// counters the shrinkage of plain Laplacian smoothing. Linear time and
+// constant memory per iteration.
+template <unsigned DIM, typename T>
+void laplacianSmoothing(T* coords, size_t numPoints, T stepSize,
+                        size_t numIterations) {
+  for (size_t i = 0; i < numIterations; ++i) {
     // One motion towards the neighbor average.
-    polylineMatrix = polylineMatrix + stepSize * laplacian * polylineMatrix;
+    laplaceStep<DIM>(coords, numPoints, stepSize);
     // One motion away from the neighbor average.
-    polylineMatrix = polylineMatrix - 0.5 * stepSize * laplacian * polylineMatrix;
+    laplaceStep<DIM>(coords, numPoints, T(-0.5) * stepSize);
+  }
+}
+
+// The iterations run tile by tile, see blockedLaplacianSmoothing, with the
+// same result as laplacianSmoothing<3> on the same coordinates.
+template <typename PointType>
+Polyline<PointType> laplacianSmoothing(const Polyline<PointType>& polyline,
+                                       float stepSize, size_t numIterations) {
+  // Smoothing runs on single precision coordinates, as rendering does, one
+  // array per coordinate.
+  const size_t numPoints = polyline.size();
+  std::vector<float> unrolledPolyline(3 * numPoints);
+  float* const coords[3] = {unrolledPolyline.data(),
+                            unrolledPolyline.data() + numPoints,
+                            unrolledPolyline.data() + 2 * numPoints};
+  size_t index = 0;
+  for (const PointType& point : polyline) {
+    coords[0][index] = point.x();
+    coords[1][index] = point.y();
+    coords[2][index] = point.z();
+    ++index;
   }
 
+  blockedLaplacianSmoothing<3>(coords, numPoints, stepSize, numIterations);
+
   // Create smoothed polyline from unrolled points.
   Polyline<PointType> smoothed;
-  for (auto iter = utils::tuple_iterator<
-           decltype(unrolledPolyline.begin()), 3,
-           Kernel::Point_3>::begin(unrolledPolyline.begin(),
-                                   unrolledPolyline.end());
-       iter !=
-           utils::tuple_iterator<decltype(unrolledPolyline.end()), 3,
-                                 Kernel::Point_3>::end(unrolledPolyline.end());
-       ++iter) {
-    smoothed.addPoint(*iter);
+  smoothed.reserve(numPoints);
+  for (index = 0; index < numPoints; ++index) {
+    smoothed.addPoint(
+        PointType(coords[0][index], coords[1][index], coords[2][index]));
   }
   return smoothed;
 }
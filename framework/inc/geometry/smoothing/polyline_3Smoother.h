@@ -1,7 +1,12 @@
 #ifndef _FRAMEWORK_GEOMETRY_SMOOTHING_POLYLINE_3_SMOOTHER_H_
 #define _FRAMEWORK_GEOMETRY_SMOOTHING_POLYLINE_3_SMOOTHER_H_
 
+#include <algorithm>
+
 #include "polyline.h"
+#include "polyloop_3.h"
+#include "adaptiveSmoothing.h"
+#include "implicitSmoothing.h"
 #include "laplacianSmoothing.h"
 
 struct Polyline_3SmoothingStrategyLaplacian {
@@ -11,6 +16,43 @@ struct Polyline_3SmoothingStrategyLaplacian {
   size_t m_numIterations;
 };
 
+// Backward Euler smoothing, with the strength of the Laplacian strategy of the
+// same stepSize and numIterations. Each Laplacian iteration moves the points
+// by stepSize along the Laplacian and back by half of it, which, to first
+// order, smooths as far as a step of stepSize / 2. The implicit strategy
+// takes the numIterations * stepSize / 2 of them at once, in numSolves
+// solves. A single solve damps the high frequencies (noise) the most; more
+// solves follow the explicit iterations more closely.
+struct Polyline_3SmoothingStrategyImplicit {
+  Polyline_3SmoothingStrategyImplicit(float stepSize, size_t numIterations,
+                                      size_t numSolves = 1)
+      : m_numSolves(std::max<size_t>(numSolves, 1)),
+        m_lambda(0.5 * stepSize * numIterations / m_numSolves) {}
+  size_t m_numSolves;
+  FieldType m_lambda;
+};
+
+// Laplacian smoothing of the noisy stretches of the polyline only, with their
+// area preserved, see curvatureAdaptiveSmoothing. noiseThreshold is in units
+// of curvature (inverse length).
+struct Polyline_3SmoothingStrategyCurvatureAdaptive {
+  Polyline_3SmoothingStrategyCurvatureAdaptive(float stepSize,
+                                               size_t numIterations,
+                                               FieldType noiseThreshold,
+                                               size_t windowMargin = 8,
+                                               size_t curvatureHalfWidth = 4)
+      : m_stepSize(stepSize),
+        m_numIterations(numIterations),
+        m_noiseThreshold(noiseThreshold),
+        m_windowMargin(windowMargin),
+        m_curvatureHalfWidth(curvatureHalfWidth) {}
+  float m_stepSize;
+  size_t m_numIterations;
+  FieldType m_noiseThreshold;
+  size_t m_windowMargin;
+  size_t m_curvatureHalfWidth;
+};
+
 class Polyline_3Smoother {
  public:
   Polyline<Kernel::Point_3> smooth(
@@ -19,6 +61,29 @@ class Polyline_3Smoother {
     return laplacianSmoothing(polyline, strategy.m_stepSize,
                               strategy.m_numIterations);
   }
+
+  // Ends are kept fixed.
+  Polyline<Kernel::Point_3> smooth(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SmoothingStrategyImplicit& strategy) {
+    return implicitSmoothing(polyline, strategy.m_lambda,
+                             strategy.m_numSolves, false);
+  }
+
+  Polyline<Kernel::Point_3> smooth(
+      const Polyline<Kernel::Point_3>& polyline,
+      const Polyline_3SmoothingStrategyCurvatureAdaptive& strategy) {
+    return curvatureAdaptiveSmoothing(
+        polyline, strategy.m_stepSize, strategy.m_numIterations,
+        strategy.m_noiseThreshold, strategy.m_windowMargin,
+        strategy.m_curvatureHalfWidth);
+  }
+
+  Polyloop_3 smooth(const Polyloop_3& polyloop,
+                    const Polyline_3SmoothingStrategyImplicit& strategy) {
+    return implicitSmoothing(polyloop, strategy.m_lambda,
+                             strategy.m_numSolves, true);
+  }
 };
 
 #endif  // _FRAMEWORK_GEOMETRY_SMOOTHING_POLYLINE_3_SMOOTHER_H_
@@ -1,6 +1,10 @@
 #ifndef _FRAMEWORK_GEOMETRY_UNIFORM_PLANAR_GRID_H_
 #define _FRAMEWORK_GEOMETRY_UNIFORM_PLANAR_GRID_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 #include <boost/iterator/iterator_facade.hpp>
 
 #include <CGAL/Origin.h>
@@ -32,50 +36,66 @@ class UniformPlanarGrid {
                        xSize, ySize);
   }
 
+  // A rectangular block of grid samples, [uBegin, uEnd) x [vBegin, vEnd).
+  struct Tile {
+    size_t uBegin;
+    size_t uEnd;
+    size_t vBegin;
+    size_t vEnd;
+
+    size_t size() const { return (uEnd - uBegin) * (vEnd - vBegin); }
+  };
+
+  // Random access iterator over the grid samples, with u varying fastest.
+  // Each sample location is computed directly off its index, so there is no
+  // error accumulation along rows, and iterators may be advanced arbitrarily,
+  // say to hand out chunks of the grid to parallel consumers.
+  //
+  // Samples are returned by value, as they are not stored. The iterator is
+  // thus random access by its boost traversal category only: its
+  // std::iterator_traits category is that of an input iterator, and
+  // operator[] returns a proxy, convertible to Kernel::Point_3.
   class PointGenerator
       : public boost::iterator_facade<PointGenerator, Kernel::Point_3,
-                                      std::input_iterator_tag,
+                                      std::random_access_iterator_tag,
                                       Kernel::Point_3> {
    public:
+    PointGenerator() : m_grid(nullptr), m_index(0) {}
+
     explicit PointGenerator(const UniformPlanarGrid& grid)
-        : m_grid(grid),
-          m_currentLocation(m_grid.m_startLocation + m_grid.m_uIncrement * 0.5 +
-                            m_grid.m_vIncrement * 0.5),
-          m_uIncrIndex(0),
-          m_vIncrIndex(0) {}
+        : m_grid(&grid), m_index(0) {}
 
     PointGenerator(const UniformPlanarGrid& grid, size_t uIncrIndex,
                    size_t vIncrIndex)
-        : m_grid(grid), m_uIncrIndex(uIncrIndex), m_vIncrIndex(vIncrIndex) {}
-
-    void increment() {
-      if (++m_uIncrIndex < std::get<0>(m_grid.m_gridSize)) {
-        m_currentLocation = m_currentLocation + m_grid.m_uIncrement;
-      } else {
-        if (++m_vIncrIndex < std::get<1>(m_grid.m_gridSize)) {
-          m_uIncrIndex = 0;
-          m_currentLocation = m_grid.m_startLocation +
-                              m_grid.m_uIncrement * 0.5 +
-                              m_grid.m_vIncrement * (m_vIncrIndex + 0.5);
-        }
-      }
+        : m_grid(&grid),
+          m_index(vIncrIndex * std::get<0>(grid.m_gridSize) + uIncrIndex) {}
+
+    // The linear index of the sample referred to
+    size_t index() const { return m_index; }
+
+   private:
+    friend class boost::iterator_core_access;
+
+    void increment() { ++m_index; }
+    void decrement() { --m_index; }
+    void advance(std::ptrdiff_t n) { m_index += n; }
+
+    std::ptrdiff_t distance_to(const PointGenerator& other) const {
+      return static_cast<std::ptrdiff_t>(other.m_index) -
+             static_cast<std::ptrdiff_t>(m_index);
     }
 
-    // Note the currentLocation is just additional state for faster grid
-    // iteration. It is not used for equality checking of the iterators.
     bool equal(const PointGenerator& other) const {
-      return ((m_uIncrIndex == other.m_uIncrIndex) &&
-              (m_vIncrIndex == other.m_vIncrIndex) &&
-              (&m_grid == &other.m_grid));
+      return (m_index == other.m_index) && (m_grid == other.m_grid);
     }
 
-    Kernel::Point_3 dereference() const { return m_currentLocation; }
+    Kernel::Point_3 dereference() const {
+      size_t xSamples = std::get<0>(m_grid->m_gridSize);
+      return m_grid->point(m_index % xSamples, m_index / xSamples);
+    }
 
-   private:
-    const UniformPlanarGrid& m_grid;
-    mutable Kernel::Point_3 m_currentLocation;
-    size_t m_uIncrIndex;
-    size_t m_vIncrIndex;
+    const UniformPlanarGrid* m_grid;
+    size_t m_index;
   };
 
   using const_iterator = PointGenerator;
@@ -83,16 +103,89 @@ class UniformPlanarGrid {
   const_iterator begin() const { return PointGenerator(*this); }
 
   const_iterator end() const {
-    return PointGenerator(*this, std::get<0>(m_gridSize),
-                          std::get<1>(m_gridSize));
+    return PointGenerator(*this, 0, std::get<1>(m_gridSize));
+  }
+
+  // Iterator to the first sample of row v
+  const_iterator rowBegin(size_t v) const {
+    return PointGenerator(*this, 0, v);
   }
 
   size_t size() const {
     return std::get<0>(m_gridSize) * std::get<1>(m_gridSize);
   }
 
+  size_t xSamples() const { return std::get<0>(m_gridSize); }
+  size_t ySamples() const { return std::get<1>(m_gridSize); }
+
+  // The sample at (u, v), in constant time.
+  Kernel::Point_3 point(size_t u, size_t v) const {
+    return m_startLocation + (u + 0.5) * m_uIncrement +
+           (v + 0.5) * m_vIncrement;
+  }
+
+  // Offsets between neighbouring samples along u and v
+  const Kernel::Vector_3& uIncrement() const { return m_uIncrement; }
+  const Kernel::Vector_3& vIncrement() const { return m_vIncrement; }
+
+  // Splits the rows of the grid into (at most) numRanges tiles spanning whole
+  // rows, of near equal size.
+  std::vector<Tile> rowRanges(size_t numRanges) const {
+    size_t ySamples = std::get<1>(m_gridSize);
+    numRanges = std::max<size_t>(1, std::min(numRanges, ySamples));
+    std::vector<Tile> ranges;
+    ranges.reserve(numRanges);
+    for (size_t range = 0; range < numRanges; ++range) {
+      ranges.push_back(Tile{0, std::get<0>(m_gridSize),
+                            range * ySamples / numRanges,
+                            (range + 1) * ySamples / numRanges});
+    }
+    return ranges;
+  }
+
+  // Splits the grid into tiles of (at most) tileU by tileV samples, row of
+  // tiles by row of tiles.
+  std::vector<Tile> tiles(size_t tileU, size_t tileV) const {
+    CGAL_precondition(tileU != 0);
+    CGAL_precondition(tileV != 0);
+    size_t xSamples = std::get<0>(m_gridSize);
+    size_t ySamples = std::get<1>(m_gridSize);
+    std::vector<Tile> gridTiles;
+    gridTiles.reserve(((xSamples + tileU - 1) / tileU) *
+                      ((ySamples + tileV - 1) / tileV));
+    for (size_t v = 0; v < ySamples; v += tileV) {
+      for (size_t u = 0; u < xSamples; u += tileU) {
+        gridTiles.push_back(Tile{u, std::min(u + tileU, xSamples), v,
+                                 std::min(v + tileV, ySamples)});
+      }
+    }
+    return gridTiles;
+  }
+
+  // Writes out the coordinates of the samples of the tile as structure of
+  // arrays, u varying fastest. Each array must hold tile.size() values.
+  void fillTileCoordinates(const Tile& tile, FieldType* xs, FieldType* ys,
+                           FieldType* zs) const {
+    const FieldType du[] = {m_uIncrement.x(), m_uIncrement.y(),
+                            m_uIncrement.z()};
+    const size_t tileWidth = tile.uEnd - tile.uBegin;
+    for (size_t v = tile.vBegin; v < tile.vEnd; ++v) {
+      Kernel::Point_3 rowStart = point(tile.uBegin, v);
+      const FieldType x0 = rowStart.x(), y0 = rowStart.y(), z0 = rowStart.z();
+      FieldType* rowXs = xs + (v - tile.vBegin) * tileWidth;
+      FieldType* rowYs = ys + (v - tile.vBegin) * tileWidth;
+      FieldType* rowZs = zs + (v - tile.vBegin) * tileWidth;
+#pragma omp simd
+      for (size_t u = 0; u < tileWidth; ++u) {
+        rowXs[u] = x0 + u * du[0];
+        rowYs[u] = y0 + u * du[1];
+        rowZs[u] = z0 + u * du[2];
+      }
+    }
+  }
+
   // Return four points that correspond to the corners of the grid
-  std::vector<Kernel::Point_3> gridCorners() {
+  std::vector<Kernel::Point_3> gridCorners() const {
     return {m_startLocation,
             m_startLocation + m_uIncrement * std::get<0>(m_gridSize),
             m_startLocation + m_uIncrement * std::get<0>(m_gridSize) +
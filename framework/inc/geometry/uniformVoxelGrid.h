@@ -1,9 +1,20 @@
 #ifndef _UNIFORM_GRID_H_
 #define _UNIFORM_GRID_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+
 #include <CGAL/Point_3.h>
 #include <CGAL/Iso_cuboid_3.h>
 #include <CGAL/Origin.h>
+#include <CGAL/Ray_3.h>
 
 #include <commonTypes.h>
 #include <partialOrder.h>
@@ -12,19 +23,62 @@
 
 // Represents a uniform voxel grid of cubical voxels.
 // Supports the following queries:
-// a) Query bounds of the voxel situated at query point - const time
+// a) Query bounds / index of the voxel situated at query point - const time
 // b) Iteration over voxels (representation by points placed at the centers)
+// c) Traversal of the voxels pierced by a ray, in order along the ray - time
+//    linear in the number of voxels crossed
+// d) Enumeration of the voxels overlapping a box or a ball - time linear in
+//    the number of voxels enumerated
+//
+// The grid is implicit: the center of voxel (i, j, k) is computed on the fly,
+// and thus, the memory needed is independent of the resolution of the grid.
+// Voxels are ordered with i varying fastest, and k slowest.
 class UniformVoxelGrid {
- private:
-  using ContainerType = std::vector<Kernel::Point_3>;
-  // The points are located at the centers of the grid.
-  ContainerType m_points;
-  // The value of one dimension (all are the same) of the grid.
-  FieldType m_gridIncrement;
-  // The bounds on the indexes of the voxel grid.
-  Integer_3 m_indexBounds;
-
  public:
+  // Random access iterator over the voxel centers. Dereferencing computes the
+  // center from the linear index of the voxel.
+  class VoxelIterator
+      : public boost::iterator_facade<VoxelIterator, Kernel::Point_3,
+                                      std::random_access_iterator_tag,
+                                      Kernel::Point_3> {
+   public:
+    VoxelIterator() : m_grid(nullptr), m_index(0) {}
+    VoxelIterator(const UniformVoxelGrid& grid, size_t index)
+        : m_grid(&grid), m_index(index) {}
+
+    // The linear index of the voxel referred to
+    size_t index() const { return m_index; }
+
+   private:
+    friend class boost::iterator_core_access;
+
+    void increment() { ++m_index; }
+    void decrement() { --m_index; }
+    void advance(std::ptrdiff_t n) { m_index += n; }
+
+    std::ptrdiff_t distance_to(const VoxelIterator& other) const {
+      return static_cast<std::ptrdiff_t>(other.m_index) -
+             static_cast<std::ptrdiff_t>(m_index);
+    }
+
+    bool equal(const VoxelIterator& other) const {
+      return (m_index == other.m_index) && (m_grid == other.m_grid);
+    }
+
+    Kernel::Point_3 dereference() const {
+      return m_grid->voxelCenter(m_index);
+    }
+
+    const UniformVoxelGrid* m_grid;
+    size_t m_index;
+  };
+
+  using value_type = Kernel::Point_3;
+  using const_iterator = VoxelIterator;
+  using iterator = VoxelIterator;
+  // A contiguous run of voxels, in iteration order.
+  using Range = std::pair<const_iterator, const_iterator>;
+
   // Rendering hint for rendering logic -- the max number of points this voxel
   // grid may possesses
   static constexpr int HINT_MAX_BOUND = 10000;
@@ -41,33 +95,229 @@ class UniformVoxelGrid {
   Kernel::Iso_cuboid_3 voxelBoundsForLocation(
       const Kernel::Point_3& location) const;
 
+  // Obtains the index of the voxel that the location lies in, with the same
+  // closed below, open above convention as voxelBoundsForLocation. Returns
+  // false for points outside the voxel grid.
+  bool voxelIndexForLocation(const Kernel::Point_3& location,
+                             Index_3& index) const {
+    const long i = voxelCoordinateIndex(location.x());
+    const long j = voxelCoordinateIndex(location.y());
+    const long k = voxelCoordinateIndex(location.z());
+    if (!isValidIndex(i) || !isValidIndex(j) || !isValidIndex(k)) {
+      return false;
+    }
+    index = Index_3(i, j, k);
+    return true;
+  }
+
+  // Visits the voxels pierced by the ray, in order along the ray (3D DDA, as
+  // by Amanatides and Woo). For each voxel, visitor(index, tEnter, tExit) is
+  // called with the ray parameters at which the ray enters and exits the
+  // voxel, where the ray is source + t * direction. Traversal stops when the
+  // visitor returns false, when the ray leaves the grid, or past maxT.
+  template <typename Visitor>
+  void traverseRay(const Kernel::Ray_3& ray, Visitor visitor,
+                   FieldType maxT =
+                       std::numeric_limits<FieldType>::infinity()) const {
+    traverseRay(ray.source(), ray.to_vector(), visitor, maxT);
+  }
+
+  template <typename Visitor>
+  void traverseRay(const Kernel::Point_3& source,
+                   const Kernel::Vector_3& direction, Visitor visitor,
+                   FieldType maxT =
+                       std::numeric_limits<FieldType>::infinity()) const {
+    const FieldType infinity = std::numeric_limits<FieldType>::infinity();
+    const FieldType origin[] = {source.x(), source.y(), source.z()};
+    const FieldType delta[] = {direction.x(), direction.y(), direction.z()};
+
+    // Clip the ray against the grid bounds (slab test).
+    FieldType tMin = 0, tMax = maxT;
+    for (int axis = 0; axis < 3; ++axis) {
+      if (delta[axis] == 0) {
+        if (origin[axis] < -m_extent || origin[axis] >= m_extent) return;
+        continue;
+      }
+      FieldType t0 = (-m_extent - origin[axis]) / delta[axis];
+      FieldType t1 = (m_extent - origin[axis]) / delta[axis];
+      if (t0 > t1) std::swap(t0, t1);
+      tMin = std::max(tMin, t0);
+      tMax = std::min(tMax, t1);
+    }
+    if (tMin > tMax) return;
+
+    // Set up the stepping from the voxel that the clipped ray starts in. Along
+    // each axis, tNext is the ray parameter of the next voxel boundary, and
+    // tDelta the ray parameter span of a voxel.
+    long index[3];
+    int step[3];
+    FieldType tNext[3], tDelta[3];
+    for (int axis = 0; axis < 3; ++axis) {
+      const FieldType entry = origin[axis] + tMin * delta[axis];
+      index[axis] = std::min<long>(
+          std::max<long>(voxelCoordinateIndex(entry), 0), m_resolution - 1);
+      if (delta[axis] > 0) {
+        step[axis] = 1;
+        tNext[axis] =
+            (voxelBoundary(index[axis] + 1) - origin[axis]) / delta[axis];
+        tDelta[axis] = m_gridIncrement / delta[axis];
+      } else if (delta[axis] < 0) {
+        step[axis] = -1;
+        tNext[axis] = (voxelBoundary(index[axis]) - origin[axis]) / delta[axis];
+        tDelta[axis] = -m_gridIncrement / delta[axis];
+      } else {
+        step[axis] = 0;
+        tNext[axis] = infinity;
+        tDelta[axis] = infinity;
+      }
+    }
+
+    FieldType tEnter = tMin;
+    while (true) {
+      int axis = tNext[0] < tNext[1] ? 0 : 1;
+      if (tNext[2] < tNext[axis]) axis = 2;
+      const FieldType tExit = std::min(tNext[axis], tMax);
+      if (!visitor(Index_3(index[0], index[1], index[2]), tEnter, tExit)) {
+        return;
+      }
+      if (tNext[axis] >= tMax) return;
+      index[axis] += step[axis];
+      if (!isValidIndex(index[axis])) return;
+      tEnter = tNext[axis];
+      tNext[axis] += tDelta[axis];
+    }
+  }
+
+  // Calls visitor(index) for each voxel that overlaps the box.
+  template <typename Visitor>
+  void voxelsInBox(const Kernel::Iso_cuboid_3& box, Visitor visitor) const {
+    long lower[3], upper[3];
+    if (!indexRange(box.xmin(), box.xmax(), lower[0], upper[0]) ||
+        !indexRange(box.ymin(), box.ymax(), lower[1], upper[1]) ||
+        !indexRange(box.zmin(), box.zmax(), lower[2], upper[2])) {
+      return;
+    }
+    for (long k = lower[2]; k <= upper[2]; ++k) {
+      for (long j = lower[1]; j <= upper[1]; ++j) {
+        for (long i = lower[0]; i <= upper[0]; ++i) {
+          visitor(Index_3(i, j, k));
+        }
+      }
+    }
+  }
+
+  // Calls visitor(index) for each voxel that overlaps the ball.
+  template <typename Visitor>
+  void voxelsInBall(const Kernel::Point_3& center, FieldType radius,
+                    Visitor visitor) const {
+    const FieldType c[] = {center.x(), center.y(), center.z()};
+    const FieldType squaredRadius = radius * radius;
+    Kernel::Iso_cuboid_3 bounds(c[0] - radius, c[1] - radius, c[2] - radius,
+                                c[0] + radius, c[1] + radius, c[2] + radius);
+    voxelsInBox(bounds, [&](const Index_3& index) {
+      // Squared distance of the center from the closest point of the voxel
+      const long voxel[] = {long(std::get<0>(index)), long(std::get<1>(index)),
+                            long(std::get<2>(index))};
+      FieldType squaredDistance = 0;
+      for (int axis = 0; axis < 3; ++axis) {
+        FieldType gap = std::max({voxelBoundary(voxel[axis]) - c[axis],
+                                  c[axis] - voxelBoundary(voxel[axis] + 1),
+                                  FieldType(0)});
+        squaredDistance += gap * gap;
+      }
+      if (squaredDistance <= squaredRadius) visitor(index);
+    });
+  }
+
+  // The center of the voxel (i, j, k), in constant time
+  Kernel::Point_3 voxelCenter(size_t i, size_t j, size_t k) const {
+    return Kernel::Point_3(voxelCoordinate(i), voxelCoordinate(j),
+                           voxelCoordinate(k));
+  }
+  Kernel::Point_3 voxelCenter(size_t linearIndex) const {
+    Index_3 index = voxelIndex(linearIndex);
+    return voxelCenter(std::get<0>(index), std::get<1>(index),
+                       std::get<2>(index));
+  }
+
+  // Conversions between (i, j, k) voxel indices and the linear index of a
+  // voxel in iteration order
+  Index_3 voxelIndex(size_t linearIndex) const {
+    return Index_3(linearIndex % m_resolution,
+                   (linearIndex / m_resolution) % m_resolution,
+                   linearIndex / (m_resolution * m_resolution));
+  }
+  size_t linearIndex(const Index_3& index) const {
+    return std::get<0>(index) +
+           m_resolution *
+               (std::get<1>(index) + m_resolution * std::get<2>(index));
+  }
+
+  // The side length of a voxel
+  FieldType voxelSize() const { return m_gridIncrement; }
+
   // The size of a voxel grid is the total number of voxels it contains
-  size_t size() const { return m_points.size(); }
+  size_t size() const { return m_resolution * m_resolution * m_resolution; }
 
   // The shape of a voxel grid is a tuple of the number of voxels in each
   // dimension
   Integer_3 shape() const { return m_indexBounds; }
-  size_t shape(size_t dimension) const {
-    if (dimension == 0) return std::get<0>(m_indexBounds);
-    if (dimension == 1) return std::get<1>(m_indexBounds);
-    if (dimension == 2) return std::get<2>(m_indexBounds);
+  size_t shape(size_t /*dimension*/) const {
+    // The grid is cubical
+    return m_resolution;
   }
 
-  // The uniform voxel grid allows for iteration over itself by pass through to
-  // container
-  auto begin() -> decltype(m_points.begin()) { return m_points.begin(); }
-  auto begin() const -> decltype(m_points.begin()) { return m_points.begin(); }
-  auto end() -> decltype(m_points.end()) { return m_points.end(); }
-  auto end() const -> decltype(m_points.end()) { return m_points.end(); }
+  const_iterator begin() const { return VoxelIterator(*this, 0); }
+  const_iterator end() const { return VoxelIterator(*this, size()); }
 
-  using value_type = Kernel::Point_3;
-  using const_iterator = ContainerType::const_iterator;
+  // Splits the voxels into (at most) numRanges contiguous ranges of near equal
+  // size, that together cover the grid. Meant to hand out work to parallel
+  // loops.
+  std::vector<Range> splitRange(size_t numRanges) const;
 
  private:
+  FieldType voxelCoordinate(size_t index) const {
+    return -m_extent + (index + 0.5) * m_gridIncrement;
+  }
+
+  // The coordinate of the lower boundary of the voxels with the given index
+  FieldType voxelBoundary(long index) const {
+    return -m_extent + index * m_gridIncrement;
+  }
+
+  // The index of the voxels spanning coordinate, unchecked against the bounds
+  long voxelCoordinateIndex(FieldType coordinate) const {
+    return static_cast<long>(
+        std::floor((coordinate + m_extent) / m_gridIncrement));
+  }
+
+  bool isValidIndex(long index) const {
+    return index >= 0 && index < static_cast<long>(m_resolution);
+  }
+
+  // The range of voxel indices overlapping [min, max] along a dimension,
+  // clamped to the grid. Returns false if the range misses the grid.
+  bool indexRange(FieldType min, FieldType max, long& lower,
+                  long& upper) const {
+    if (max < -m_extent || min >= m_extent || min > max) return false;
+    lower = std::max<long>(voxelCoordinateIndex(min), 0);
+    upper = std::min<long>(voxelCoordinateIndex(max), m_resolution - 1);
+    return true;
+  }
+
   // Return if a particular index is valid
-  bool isValidIndex(const Index_3& index) {
+  bool isValidIndex(const Index_3& index) const {
     return PartialOrder<Index_3>()(index, m_indexBounds);
   }
+
+  // The grid spans [-m_extent, m_extent] in each dimension.
+  FieldType m_extent;
+  // The number of voxels along each dimension.
+  size_t m_resolution;
+  // The value of one dimension (all are the same) of the grid.
+  FieldType m_gridIncrement;
+  // The bounds on the indexes of the voxel grid.
+  Integer_3 m_indexBounds;
 };
 
 #endif  //_UNIFORM_GRID_H_
@@ -29,6 +29,9 @@ class VoxelGridPointProvider {
   auto end() const -> decltype(m_voxelGrid.end()) { return m_voxelGrid.end(); }
 };
 
+// Emits all 12 triangles of every voxel, with unshared vertices. Voxels are
+// rendered through VoxelMesher instead, as an IndexedTriangleMesh of the
+// exposed faces only (see DynamicMeshManager::addMesh).
 class VoxelGridCubeProvider {
  private:
   const UniformVoxelGrid& m_voxelGrid;
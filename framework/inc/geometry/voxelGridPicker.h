@@ -0,0 +1,73 @@
+#ifndef _FRAMEWORK_GEOMETRY_VOXEL_GRID_PICKER_H_
+#define _FRAMEWORK_GEOMETRY_VOXEL_GRID_PICKER_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "brickedVoxelData.h"
+#include "geometryTypes.h"
+#include "uniformVoxelGrid.h"
+
+// Picks the occupied voxels of a voxel grid with rays. A query walks the
+// voxels pierced by the ray, front to back, up to the first occupied one, and
+// selecting picks the voxel found by the last query, if any. The grid and
+// occupancy must remain valid during the use of this object.
+class VoxelGridPicker {
+ public:
+  // A voxel is occupied if its payload is non zero.
+  using Occupancy = BrickedVoxelData<std::uint8_t>;
+
+  VoxelGridPicker(const UniformVoxelGrid& voxelGrid,
+                  const Occupancy& occupancy)
+      : m_voxelGrid(voxelGrid),
+        m_occupancy(occupancy),
+        m_hasHit(false),
+        m_hasSelection(false) {}
+
+  // The distance along the ray to the first occupied voxel, or infinity if
+  // the ray misses all of them.
+  FieldType queryDistance(const Kernel::Ray_3& ray) {
+    m_hasHit = false;
+    FieldType hitT = 0;
+    m_voxelGrid.traverseRay(
+        ray, [this, &hitT](const Index_3& index, FieldType tEnter, FieldType) {
+          if (!m_occupancy.at(index)) return true;
+          m_hitVoxel = index;
+          m_hasHit = true;
+          hitT = tEnter;
+          return false;
+        });
+    if (!m_hasHit) return std::numeric_limits<FieldType>::infinity();
+    return hitT * std::sqrt(ray.to_vector().squared_length());
+  }
+
+  // Whether the last query found an occupied voxel
+  bool hasHit() const { return m_hasHit; }
+
+  // Picks the voxel found by the last query, if any, else clears the
+  // selection. Returns whether a voxel is picked.
+  bool select() {
+    m_hasSelection = m_hasHit;
+    m_selectedVoxel = m_hitVoxel;
+    return m_hasSelection;
+  }
+
+  // Obtains the index of the picked voxel. Returns false if none is picked.
+  bool selectedVoxel(Index_3& index) const {
+    if (!m_hasSelection) return false;
+    index = m_selectedVoxel;
+    return true;
+  }
+
+ private:
+  const UniformVoxelGrid& m_voxelGrid;
+  const Occupancy& m_occupancy;
+  // The first occupied voxel along the ray of the last query
+  bool m_hasHit;
+  Index_3 m_hitVoxel;
+  bool m_hasSelection;
+  Index_3 m_selectedVoxel;
+};
+
+#endif  // _FRAMEWORK_GEOMETRY_VOXEL_GRID_PICKER_H_
@@ -0,0 +1,60 @@
+#ifndef _FRAMEWORK_GEOMETRY_VOXEL_MESHER_H_
+#define _FRAMEWORK_GEOMETRY_VOXEL_MESHER_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "brickedVoxelData.h"
+#include "indexedTriangleMesh.h"
+#include "uniformVoxelGrid.h"
+
+// Builds a renderable surface for the occupied voxels of a voxel grid. Only
+// the exposed faces are emitted, that is, faces between an occupied voxel and
+// an empty voxel (or the outside of the grid). Faces shared by two occupied
+// voxels are hidden, and skipped. Vertices are shared between faces, and
+// triangles are wound counterclockwise when seen from outside the occupied
+// region.
+//
+// Optionally, coplanar exposed faces are greedily merged into larger
+// rectangles, which typically cuts down the triangle count by an order of
+// magnitude for blocky shapes. Merged rectangles may produce T-junctions,
+// which is of no consequence for flat shaded rendering.
+class VoxelMesher {
+ public:
+  using IndexType = IndexedTriangleMesh::IndexType;
+  // A voxel is occupied if its payload is non zero.
+  using Occupancy = BrickedVoxelData<std::uint8_t>;
+
+  explicit VoxelMesher(const UniformVoxelGrid& grid);
+
+  // Replaces the contents of mesh by the exposed faces of the occupied voxels.
+  void build(const Occupancy& occupancy, IndexedTriangleMesh& mesh,
+             bool mergeFaces = false);
+
+ private:
+  // Sweeps the slice planes orthogonal to axis, emitting the exposed faces in
+  // each of them.
+  void buildAxis(const Occupancy& occupancy, int axis, bool mergeFaces,
+                 IndexedTriangleMesh& mesh);
+
+  // Adds the rectangle spanning [u, u + width] x [v, v + height] on the
+  // slice plane, with its normal along +axis if facesUp, else along -axis.
+  void addQuad(int axis, size_t slice, size_t u, size_t v, size_t width,
+               size_t height, bool facesUp, IndexedTriangleMesh& mesh);
+
+  // Returns the mesh vertex at grid node (i, j, k), creating it if needed.
+  IndexType nodeVertex(size_t i, size_t j, size_t k,
+                       IndexedTriangleMesh& mesh);
+
+  size_t m_resolution;
+  // The lowest corner of the grid, in each dimension
+  FieldType m_origin;
+  FieldType m_voxelSize;
+  std::unordered_map<std::uint64_t, IndexType> m_nodeVertices;
+  // Exposed faces of the current slice: +1 for faces looking along +axis, -1
+  // for ones looking along -axis, 0 for none.
+  std::vector<std::int8_t> m_faceMask;
+};
+
+#endif  //_FRAMEWORK_GEOMETRY_VOXEL_MESHER_H_
@@ -10,6 +10,7 @@
 #include "vertexElementBufferProvider.h"
 #include "singleElementProviderAdaptor.h"
 #include "geometryMesh.h"
+#include "indexedGeometryMesh.h"
 #include "geometryRenderable.h"
 
 // By default assume that the GeometryRenderable provides only position vertex
@@ -54,6 +55,15 @@ std::string make_mesh_renderable(const GeometryRep& geometryRep,
   return meshName;
 }
 
+// Indexed triangle meshes already hold GPU ready buffers, and are uploaded as
+// is.
+inline std::string make_mesh_renderable(const IndexedTriangleMesh& mesh,
+                                        const std::string& meshName) {
+  IndexedGeometryMeshCreator renderable(meshName);
+  renderable.setMeshData(mesh);
+  return meshName;
+}
+
 // Make a mesh with a uuid name.
 template <typename GeometryRep>
 std::string make_mesh_renderable(const GeometryRep& geometryRep) {
@@ -5,8 +5,10 @@
 // rendering implementations (CGAL and Ogre)
 
 #include <CGAL/Iso_cuboid_3.h>
+#include <CGAL/Ray_3.h>
 
 #include <OGRE/OgreAxisAlignedBox.h>
+#include <OGRE/OgreRay.h>
 
 #include "geometryTypes.h"
 
@@ -19,6 +21,11 @@ class GeometryInterop {
 
   // In Ogre, Vector3 is used to represent both a point and a vector
   static Ogre::Vector3 renderingFromGeom(const Kernel::Point_3& point);
+
+  static Kernel::Point_3 geomPointFromRendering(const Ogre::Vector3& point);
+
+  // Selection rays, say, for picking voxels by traversing a voxel grid
+  static Kernel::Ray_3 geomFromRendering(const Ogre::Ray& ray);
 };
 
 #endif  //_FRAMEWORK_RENDERING_GEOMETRY_INTEROP_H_
@@ -0,0 +1,28 @@
+#ifndef _FRAMEWORK_RENDERING_INDEXED_GEOMETRY_MESH_H_
+#define _FRAMEWORK_RENDERING_INDEXED_GEOMETRY_MESH_H_
+
+#include <string>
+
+#include <OGRE/OgreMesh.h>
+
+#include "indexedTriangleMesh.h"
+#include "renderingConstants.h"
+
+// An indexed geometry mesh creator wraps an IndexedTriangleMesh in an Ogre
+// mesh. Unlike the GeometryMeshCreator, which streams unshared vertices out of
+// a vertex buffer provider, the position and index buffers of the indexed mesh
+// are copied as is into static hardware buffers, with 32-bit indices.
+class IndexedGeometryMeshCreator {
+ public:
+  IndexedGeometryMeshCreator(
+      const std::string& meshName,
+      const std::string& groupName = DEFAULT_RENDER_GROUP_NAME,
+      const std::string& materialName = DEFAULT_TRIANGLE_MATERIAL_NAME);
+
+  void setMeshData(const IndexedTriangleMesh& mesh);
+
+ private:
+  Ogre::MeshPtr m_mesh;
+};
+
+#endif  //_FRAMEWORK_RENDERING_INDEXED_GEOMETRY_MESH_H_
@@ -24,7 +24,8 @@ enum SelectionQueryFlags {
 // object. The SelectableObject also provides a setSelected function that the
 // SelectionManager uses to notify if of selection. The queryDistance call can
 // cache information that will be useful for handling a setSelected call if so
-// desired.
+// desired. VoxelGridSelectableObject picks voxels this way, by traversing its
+// voxel grid along the selection ray.
 class SelectionManager {
  public:
   SelectionManager() : m_camera(nullptr), m_selectedObject(nullptr) {}
@@ -0,0 +1,52 @@
+#ifndef _FRAMEWORK_RENDERING_VOXEL_GRID_SELECTABLE_OBJECT_H_
+#define _FRAMEWORK_RENDERING_VOXEL_GRID_SELECTABLE_OBJECT_H_
+
+#include <limits>
+
+#include <OGRE/OgreSceneNode.h>
+
+#include "geometryInterop.h"
+#include "selectableObject.h"
+#include "voxelGridPicker.h"
+
+// Picks voxels of a voxel grid, as rendered by movableObject (say, the mesh
+// of the occupied voxels built by VoxelMesher), through VoxelGridPicker. The
+// grid and occupancy must remain valid during the use of this object.
+class VoxelGridSelectableObject : public ISelectableObject {
+ public:
+  using Occupancy = VoxelGridPicker::Occupancy;
+
+  VoxelGridSelectableObject(Ogre::MovableObject* movableObject,
+                            const UniformVoxelGrid& voxelGrid,
+                            const Occupancy& occupancy)
+      : m_movable(movableObject), m_picker(voxelGrid, occupancy) {}
+
+  // The distance along the ray to the first occupied voxel, or the largest
+  // float if the ray misses all of them.
+  float queryDistance(const Ogre::Ray& oray) override {
+    FieldType distance =
+        m_picker.queryDistance(GeometryInterop::geomFromRendering(oray));
+    if (!m_picker.hasHit()) return std::numeric_limits<float>::max();
+    return distance;
+  }
+
+  Ogre::MovableObject* movableObject() const override { return m_movable; }
+
+  // Picks the voxel found by the last query, if any.
+  void setSelected(const Ogre::Ray& /**/) override {
+    if (m_picker.select()) {
+      m_movable->getParentSceneNode()->showBoundingBox(true);
+    }
+  }
+
+  // Obtains the index of the picked voxel. Returns false if none is picked.
+  bool selectedVoxel(Index_3& index) const {
+    return m_picker.selectedVoxel(index);
+  }
+
+ private:
+  Ogre::MovableObject* m_movable;
+  VoxelGridPicker m_picker;
+};
+
+#endif  // _FRAMEWORK_RENDERING_VOXEL_GRID_SELECTABLE_OBJECT_H_
@@ -13,3 +13,14 @@ Ogre::AxisAlignedBox GeometryInterop::renderingFromGeom(
   return Ogre::AxisAlignedBox(renderingFromGeom(boundingBox.min()),
                               renderingFromGeom(boundingBox.max()));
 }
+
+Kernel::Point_3 GeometryInterop::geomPointFromRendering(
+    const Ogre::Vector3& point) {
+  return Kernel::Point_3(point.x, point.y, point.z);
+}
+
+Kernel::Ray_3 GeometryInterop::geomFromRendering(const Ogre::Ray& ray) {
+  const Ogre::Vector3& direction = ray.getDirection();
+  return Kernel::Ray_3(geomPointFromRendering(ray.getOrigin()),
+                       Kernel::Vector_3(direction.x, direction.y, direction.z));
+}
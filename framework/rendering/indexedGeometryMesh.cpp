@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include <OGRE/OgreHardwareBufferManager.h>
+#include <OGRE/OgreMeshManager.h>
+#include <OGRE/OgreSubMesh.h>
+
+#include "indexedGeometryMesh.h"
+#include "vertexElement.h"
+
+IndexedGeometryMeshCreator::IndexedGeometryMeshCreator(
+    const std::string& meshName, const std::string& groupName,
+    const std::string& materialName) {
+  m_mesh = Ogre::MeshManager::getSingleton().createManual(meshName, groupName);
+  Ogre::SubMesh* submesh = m_mesh->createSubMesh();
+  submesh->setMaterialName(materialName);
+  submesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+  submesh->useSharedVertices = true;
+
+  LOG(INFO) << "Created an indexed geometry mesh with material "
+            << materialName;
+}
+
+void IndexedGeometryMeshCreator::setMeshData(const IndexedTriangleMesh& mesh) {
+  const std::vector<float>& positions = mesh.positions();
+  const std::vector<IndexedTriangleMesh::IndexType>& indices = mesh.indices();
+
+  // Bounds
+  Ogre::AxisAlignedBox boundingBox;
+  if (mesh.numVertices() > 0) {
+    Ogre::Vector3 minCorner(std::numeric_limits<float>::max());
+    Ogre::Vector3 maxCorner(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < positions.size();
+         i += IndexedTriangleMesh::COORDINATES_PER_VERTEX) {
+      Ogre::Vector3 position(&positions[i]);
+      minCorner.makeFloor(position);
+      maxCorner.makeCeil(position);
+    }
+    boundingBox.setExtents(minCorner, maxCorner);
+  }
+  m_mesh->_setBounds(boundingBox);
+  Ogre::Vector3 size = boundingBox.isFinite() ? boundingBox.getSize()
+                                              : Ogre::Vector3::ZERO;
+  m_mesh->_setBoundingSphereRadius(
+      std::max(std::max(size.x, size.y), size.z) / 2);
+
+  // Vertex data, a single position buffer
+  m_mesh->sharedVertexData = new Ogre::VertexData();
+  Ogre::VertexData* vertexData = m_mesh->sharedVertexData;
+  vertexData->vertexCount = mesh.numVertices();
+  Ogre::VertexDeclaration* decl = vertexData->vertexDeclaration;
+  decl->addElement(PositionVertexElement::bindingLocation, 0,
+                   PositionVertexElement::type,
+                   PositionVertexElement::semantic);
+  if (vertexData->vertexCount > 0) {
+    Ogre::HardwareVertexBufferSharedPtr vbuf =
+        Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(PositionVertexElement::bindingLocation),
+            vertexData->vertexCount,
+            Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    vbuf->writeData(0, vbuf->getSizeInBytes(), positions.data(), true);
+    vertexData->vertexBufferBinding->setBinding(
+        PositionVertexElement::bindingLocation, vbuf);
+  }
+
+  // Index data
+  Ogre::IndexData* indexData = m_mesh->getSubMesh(0)->indexData;
+  indexData->indexStart = 0;
+  indexData->indexCount = indices.size();
+  if (indexData->indexCount > 0) {
+    indexData->indexBuffer =
+        Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+            Ogre::HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
+            Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    indexData->indexBuffer->writeData(
+        0, indexData->indexBuffer->getSizeInBytes(), indices.data(), true);
+  }
+
+  // Notify mesh loading completion
+  m_mesh->load();
+}
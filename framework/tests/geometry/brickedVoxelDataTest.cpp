@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "brickedVoxelData.h"
+
+// A resolution that is not a multiple of the brick size, to exercise the
+// partially filled bricks.
+constexpr size_t RESOLUTION = 19;
+
+class BrickedVoxelDataTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    for (size_t k = 0; k < RESOLUTION; ++k) {
+      for (size_t j = 0; j < RESOLUTION; ++j) {
+        for (size_t i = 0; i < RESOLUTION; ++i) {
+          data.at(i, j, k) = encode(i, j, k);
+        }
+      }
+    }
+  }
+
+  static long encode(long i, long j, long k) {
+    return i + 1000 * j + 1000000 * k;
+  }
+
+  BrickedVoxelData<long> data{RESOLUTION, -1};
+};
+
+TEST_F(BrickedVoxelDataTest, storageIsUnique) {
+  std::set<size_t> storageIndices;
+  for (size_t k = 0; k < RESOLUTION; ++k) {
+    for (size_t j = 0; j < RESOLUTION; ++j) {
+      for (size_t i = 0; i < RESOLUTION; ++i) {
+        storageIndices.insert(data.storageIndex(i, j, k));
+      }
+    }
+  }
+  EXPECT_EQ(data.size(), storageIndices.size());
+  EXPECT_EQ(encode(17, 3, 18), data.at(17, 3, 18));
+}
+
+TEST_F(BrickedVoxelDataTest, mortonOrderWithinBrick) {
+  // The first 2x2x2 block of a brick is contiguous
+  EXPECT_EQ(0, data.storageIndex(0, 0, 0));
+  EXPECT_EQ(1, data.storageIndex(1, 0, 0));
+  EXPECT_EQ(2, data.storageIndex(0, 1, 0));
+  EXPECT_EQ(4, data.storageIndex(0, 0, 1));
+  EXPECT_EQ(7, data.storageIndex(1, 1, 1));
+  EXPECT_EQ(8, data.storageIndex(2, 0, 0));
+  // The next brick along i follows the first one
+  EXPECT_EQ(BrickedVoxelData<long>::BRICK_VOXELS, data.storageIndex(8, 0, 0));
+}
+
+TEST_F(BrickedVoxelDataTest, neighborAccess) {
+  // Within a brick, across brick boundaries, and clamped at the grid boundary
+  auto cursor = data.cursor(7, 8, 0);
+  EXPECT_EQ(encode(7, 8, 0), cursor.value());
+  EXPECT_EQ(encode(6, 8, 0), cursor.neighbor(-1, 0, 0));
+  EXPECT_EQ(encode(8, 8, 0), cursor.neighbor(1, 0, 0));
+  EXPECT_EQ(encode(7, 7, 0), cursor.neighbor(0, -1, 0));
+  EXPECT_EQ(encode(8, 9, 1), cursor.neighbor(1, 1, 1));
+  EXPECT_EQ(encode(7, 8, 0), cursor.neighbor(0, 0, -1));
+
+  cursor.moveTo(RESOLUTION - 1, RESOLUTION - 1, RESOLUTION - 1);
+  const long last = RESOLUTION - 1;
+  EXPECT_EQ(encode(last, last, last), cursor.neighbor(1, 1, 1));
+  EXPECT_EQ(encode(last - 1, last, last), cursor.neighbor(-1, 1, 0));
+}
+
+TEST_F(BrickedVoxelDataTest, forEachVoxel) {
+  BrickedVoxelData<int> visits(RESOLUTION, 0);
+  visits.forEachVoxel([](size_t, size_t, size_t, int& value) { ++value; });
+  size_t numVisits = 0;
+  for (size_t k = 0; k < RESOLUTION; ++k) {
+    for (size_t j = 0; j < RESOLUTION; ++j) {
+      for (size_t i = 0; i < RESOLUTION; ++i) {
+        EXPECT_EQ(1, visits.at(i, j, k));
+        numVisits += visits.at(i, j, k);
+      }
+    }
+  }
+  EXPECT_EQ(visits.size(), numVisits);
+
+  data.forEachVoxel([this](size_t i, size_t j, size_t k, long& value) {
+    EXPECT_EQ(encode(i, j, k), value);
+  });
+}
+
+TEST(BrickedVoxelDataGridTest, fromVoxelGrid) {
+  UniformVoxelGrid grid(10.0, 16);
+  BrickedVoxelData<float> data(grid, 1.0f);
+  EXPECT_EQ(grid.size(), data.size());
+  EXPECT_EQ(1.0f, data.at(15, 15, 15));
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "biarc_3.h"
+#include "gcodeWriter.h"
+
+namespace {
+
+// A quarter circle of radius 1 about the origin, in the XY plane, from (1, 0)
+// to (0, 1), sweeping counter clockwise about normal.
+CurvePrimitive_3 quarterArc(const Kernel::Vector_3& normal, double sweep) {
+  return CurvePrimitive_3::arc(Kernel::Point_3(0, 0, 0), normal,
+                               Kernel::Point_3(1, 0, 0),
+                               Kernel::Point_3(0, 1, 0), sweep);
+}
+
+}  // end anonymous namespace
+
+TEST(Biarc_3Test, arcGeometry) {
+  CurvePrimitive_3 arc = quarterArc(Kernel::Vector_3(0, 0, 1), M_PI / 2);
+  EXPECT_NEAR(1, arc.radius(), 1e-12);
+  EXPECT_NEAR(M_PI / 2, arc.length(), 1e-12);
+  Kernel::Point_3 middle = arc.pointAt(0.5);
+  EXPECT_NEAR(std::sqrt(0.5), middle.x(), 1e-12);
+  EXPECT_NEAR(std::sqrt(0.5), middle.y(), 1e-12);
+
+  // The long way round, clockwise about the same normal
+  CurvePrimitive_3 longArc =
+      quarterArc(Kernel::Vector_3(0, 0, 1), -3 * M_PI / 2);
+  middle = longArc.pointAt(0.5);
+  EXPECT_NEAR(-std::sqrt(0.5), middle.x(), 1e-12);
+  EXPECT_NEAR(-std::sqrt(0.5), middle.y(), 1e-12);
+}
+
+TEST(Biarc_3Test, toPolyline) {
+  Biarc_3 curve;
+  curve.addPrimitive(CurvePrimitive_3::line(Kernel::Point_3(2, 0, 0),
+                                            Kernel::Point_3(1, 0, 0)));
+  curve.addPrimitive(quarterArc(Kernel::Vector_3(0, 0, 1), M_PI / 2));
+  EXPECT_EQ(2, curve.size());
+
+  const double maxChordError = 1e-3;
+  Polyline<Kernel::Point_3> polyline = curve.toPolyline(maxChordError);
+  EXPECT_EQ(2 + curve.begin()[1].numChords(maxChordError), polyline.size());
+  EXPECT_EQ(Kernel::Point_3(2, 0, 0), *polyline.begin());
+  EXPECT_EQ(Kernel::Point_3(0, 1, 0), *(polyline.end() - 1));
+  // Chords midpoints are within the chord error of the arc.
+  for (auto point = polyline.begin() + 1; point + 1 != polyline.end();
+       ++point) {
+    const Kernel::Point_3 middle = CGAL::midpoint(*point, *(point + 1));
+    const double radius = std::sqrt(middle.x() * middle.x() +
+                                    middle.y() * middle.y());
+    EXPECT_LE(1 - radius, maxChordError * (1 + 1e-9));
+  }
+}
+
+TEST(GCodeWriterTest, arcsInCoordinatePlanes) {
+  Biarc_3 curve;
+  curve.addPrimitive(quarterArc(Kernel::Vector_3(0, 0, 1), M_PI / 2));
+  curve.addPrimitive(CurvePrimitive_3::line(Kernel::Point_3(0, 1, 0),
+                                            Kernel::Point_3(0, 2, 0)));
+  // From (0, 2, 0) about (0, 1, 0), clockwise seen from +Z
+  curve.addPrimitive(CurvePrimitive_3::arc(
+      Kernel::Point_3(0, 1, 0), Kernel::Vector_3(0, 0, -1),
+      Kernel::Point_3(0, 2, 0), Kernel::Point_3(1, 1, 0), M_PI / 2));
+  // In the XZ plane, counter clockwise about +Y
+  curve.addPrimitive(CurvePrimitive_3::arc(
+      Kernel::Point_3(1, 1, 1), Kernel::Vector_3(0, 1, 0),
+      Kernel::Point_3(1, 1, 0), Kernel::Point_3(0, 1, 1), M_PI / 2));
+
+  GCodeWriterParams params;
+  params.feed_rate = 100;
+  params.precision = 3;
+  std::ostringstream out;
+  GCodeWriter(params).write(curve, out);
+  EXPECT_EQ(
+      "G90\n"
+      "G00 X1.000 Y0.000 Z0.000\n"
+      "G17\n"
+      "G03 X0.000 Y1.000 Z0.000 I-1.000 J0.000 F100.000\n"
+      "G01 X0.000 Y2.000 Z0.000\n"
+      "G02 X1.000 Y1.000 Z0.000 I0.000 J-1.000\n"
+      "G18\n"
+      "G03 X0.000 Y1.000 Z1.000 I0.000 K1.000\n",
+      out.str());
+}
+
+TEST(GCodeWriterTest, obliqueArcsAreLinearized) {
+  Biarc_3 curve;
+  const double normalLength = std::sqrt(2);
+  curve.addPrimitive(CurvePrimitive_3::arc(
+      Kernel::Point_3(0, 0, 0),
+      Kernel::Vector_3(0, -1 / normalLength, 1 / normalLength),
+      Kernel::Point_3(1, 0, 0),
+      Kernel::Point_3(0, 1 / normalLength, 1 / normalLength), M_PI / 2));
+
+  GCodeWriterParams params;
+  params.linearization_tolerance = 1e-2;
+  std::ostringstream out;
+  GCodeWriter(params).write(curve, out);
+  const std::string gcode = out.str();
+  EXPECT_EQ(std::string::npos, gcode.find("G02"));
+  EXPECT_EQ(std::string::npos, gcode.find("G03"));
+
+  size_t numMoves = 0;
+  for (size_t pos = gcode.find("G01"); pos != std::string::npos;
+       pos = gcode.find("G01", pos + 1)) {
+    ++numMoves;
+  }
+  EXPECT_EQ(curve.begin()->numChords(params.linearization_tolerance),
+            numMoves);
+  EXPECT_NE(std::string::npos, gcode.find("G01 X0.0000 Y0.7071 Z0.7071\n"));
+}
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "indexedTriangleMesh.h"
+#include "plyMeshWriter.h"
+
+class PlyMeshWriterTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // A unit square, split into two triangles
+    mesh.addVertex(0, 0, 0);
+    mesh.addVertex(1, 0, 0);
+    mesh.addVertex(1, 1, 0);
+    mesh.addVertex(0, 1, 0);
+    mesh.addTriangle(0, 1, 2);
+    mesh.addTriangle(0, 2, 3);
+  }
+  virtual void TearDown() { std::remove(filePath.c_str()); }
+
+  std::string readFile() {
+    std::ifstream file(filePath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+  }
+
+  IndexedTriangleMesh mesh;
+  const std::string filePath = "plyMeshWriterTest.ply";
+};
+
+TEST_F(PlyMeshWriterTest, headerAndBody) {
+  ASSERT_TRUE(PlyMeshWriter::write(mesh, filePath));
+  std::string content = readFile();
+
+  const std::string endHeader = "end_header\n";
+  size_t bodyStart = content.find(endHeader);
+  ASSERT_NE(bodyStart, std::string::npos);
+  bodyStart += endHeader.size();
+  std::string header = content.substr(0, bodyStart);
+  EXPECT_EQ(header.find("ply\nformat binary_"), 0);
+  EXPECT_NE(header.find("element vertex 4\n"), std::string::npos);
+  EXPECT_NE(header.find("element face 2\n"), std::string::npos);
+  EXPECT_NE(header.find("property list uchar uint vertex_indices\n"),
+            std::string::npos);
+
+  // 4 vertices of 3 floats, and 2 faces of a count and 3 indices
+  ASSERT_EQ(content.size() - bodyStart,
+            4 * 3 * sizeof(float) + 2 * (1 + 3 * sizeof(std::uint32_t)));
+  const char* body = content.data() + bodyStart;
+  float x;
+  std::memcpy(&x, body + 6 * sizeof(float), sizeof(float));
+  EXPECT_FLOAT_EQ(x, 1);
+
+  const char* faces = body + 4 * 3 * sizeof(float);
+  std::uint32_t index;
+  EXPECT_EQ(faces[13], 3);
+  std::memcpy(&index, faces + 14 + 2 * sizeof(std::uint32_t), sizeof(index));
+  EXPECT_EQ(index, 3);
+}
+
+TEST_F(PlyMeshWriterTest, asyncWrite) {
+  std::string syncContent;
+  ASSERT_TRUE(PlyMeshWriter::write(mesh, filePath));
+  syncContent = readFile();
+  std::remove(filePath.c_str());
+
+  PlyMeshWriter writer;
+  writer.writeAsync(mesh, filePath);
+  ASSERT_TRUE(writer.wait());
+  EXPECT_EQ(readFile(), syncContent);
+}
+
+TEST_F(PlyMeshWriterTest, badPath) {
+  EXPECT_FALSE(PlyMeshWriter::write(mesh, "nonexistent/dir/mesh.ply"));
+}
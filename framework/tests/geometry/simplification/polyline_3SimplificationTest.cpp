@@ -1,7 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <psimpl.h>
+
 #include <polyline.h>
+#include <simplification/circleFit.h>
+#include <simplification/parallelDouglasPeucker.h>
+#include <simplification/polyline_3DouglasPeuckerRanking.h>
+#include <simplification/polyline_3ErrorEvaluator.h>
 #include <simplification/polyline_3Simplifier.h>
+#include <simplification/polyline_3StreamingSimplifier.h>
+#include <simplification/psimplAdapters.h>
 
 using Polyline_3 = Polyline<Kernel::Point_3>;
 
@@ -37,3 +52,621 @@ TEST(Polyline_3SimplificationTest, circleFitCompound) {
       simplifier.simplify(line, Polyline_3SimplificationStrategyNaiveBiarc());
   EXPECT_EQ(std::get<0>(result), 2);
 }
+
+TEST(Polyline_3SimplificationTest, circleFitArcPrimitives) {
+  // Densely sampled semicircle, and a line on
+  Polyline_3 line;
+  const int numSamples = 50;
+  for (int sample = 0; sample <= numSamples; ++sample) {
+    double angle = M_PI * (1 - double(sample) / numSamples);
+    line.addPoint(Kernel::Point_3(std::cos(angle), std::sin(angle), 0));
+  }
+  line.addPoint(Kernel::Point_3(1, -1, 0));
+  line.addPoint(Kernel::Point_3(1, -2, 0));
+
+  Polyline_3Simplifier simplifier(0.01);
+  auto result = simplifier.simplifyToArcs(
+      line, Polyline_3SimplificationStrategyNaiveBiarc());
+  const Biarc_3& arcs = std::get<1>(result);
+  ASSERT_EQ(2, std::get<0>(result));
+  ASSERT_EQ(2, arcs.size());
+
+  const CurvePrimitive_3& arc = arcs.begin()[0];
+  ASSERT_TRUE(arc.isArc());
+  EXPECT_EQ(*line.begin(), arc.start);
+  EXPECT_EQ(*(line.begin() + numSamples), arc.end);
+  EXPECT_NEAR(1, arc.radius(), 0.01);
+  EXPECT_NEAR(M_PI, std::abs(arc.sweep), 0.01);
+  // Clockwise seen from +Z, through the top of the circle
+  Kernel::Point_3 top = arc.pointAt(0.5);
+  EXPECT_NEAR(0, top.x(), 0.01);
+  EXPECT_NEAR(1, top.y(), 0.01);
+
+  const CurvePrimitive_3& tail = arcs.begin()[1];
+  EXPECT_FALSE(tail.isArc());
+  EXPECT_EQ(arc.end, tail.start);
+  EXPECT_EQ(Kernel::Point_3(1, -2, 0), tail.end);
+
+  // The polyline result samples the arcs, at a fraction of the tolerance,
+  // rather than keeping every input point.
+  auto sampled =
+      simplifier.simplify(line, Polyline_3SimplificationStrategyNaiveBiarc());
+  EXPECT_EQ(2, std::get<0>(sampled));
+  EXPECT_LT(std::get<1>(sampled).size(), line.size());
+}
+
+// Points on the circle of radius 2 about the origin, in the plane of normal
+// (0, 1, 1), from the angle 0 to sweep.
+Polyline_3 tiltedArc(size_t numPoints, double sweep) {
+  Polyline_3 arc;
+  for (size_t point = 0; point < numPoints; ++point) {
+    double angle = sweep * point / (numPoints - 1);
+    arc.addPoint(Kernel::Point_3(2 * std::cos(angle),
+                                 M_SQRT2 * std::sin(angle),
+                                 -M_SQRT2 * std::sin(angle)));
+  }
+  return arc;
+}
+
+// The sine of the angle between the normal of plane and direction
+double sinAngleToNormal(const Kernel::Plane_3& plane,
+                        const Kernel::Vector_3& direction) {
+  Kernel::Vector_3 normal = plane.orthogonal_vector();
+  return std::sqrt(CGAL::cross_product(normal, direction).squared_length() /
+                   (normal.squared_length() * direction.squared_length()));
+}
+
+TEST(Polyline_3SimplificationTest, wedgeOfPlanarArc) {
+  Polyline_3 arc = tiltedArc(100, M_PI);
+  circle_fit::WedgeTracker tracker(*arc.begin(), 0.01);
+  for (const Kernel::Point_3& point : arc) tracker.addPoint(point);
+
+  // The intervals of all points are centered on the plane of the arc, and so
+  // is the wedge, whether evaluated at once, or from the wedge of an earlier
+  // end.
+  const Kernel::Vector_3 arcNormal(0, 1, 1);
+  circle_fit::Wedge wedge = tracker.wedge(*(arc.begin() + 99), 99);
+  ASSERT_TRUE(wedge.valid);
+  EXPECT_TRUE(wedge.constrained);
+  EXPECT_NEAR(0, sinAngleToNormal(tracker.bisector(wedge), arcNormal), 1e-9);
+
+  circle_fit::Wedge earlier = tracker.wedge(*(arc.begin() + 40), 40);
+  circle_fit::Wedge later = tracker.wedge(*(arc.begin() + 99), 99, earlier);
+  ASSERT_TRUE(later.valid);
+  EXPECT_EQ(99, later.numPoints);
+  EXPECT_NEAR(0, sinAngleToNormal(tracker.bisector(later), arcNormal), 1e-9);
+}
+
+TEST(Polyline_3SimplificationTest, wedgeConstrainedByPointsOffPivot) {
+  const Kernel::Point_3 end(10, 0, 0);
+  circle_fit::WedgeTracker tracker(Kernel::Point_3(0, 0, 0), 0.1);
+  tracker.addPoint(Kernel::Point_3(0, 0, 0));
+
+  // A point within tolerance of the pivot line is within tolerance of any
+  // plane through it.
+  tracker.addPoint(Kernel::Point_3(5, 0, 0.05));
+  circle_fit::Wedge wedge = tracker.wedge(end, 2);
+  EXPECT_TRUE(wedge.valid);
+  EXPECT_FALSE(wedge.constrained);
+
+  // Points further off constrain the wedge to the planes near theirs.
+  tracker.addPoint(Kernel::Point_3(5, 1, 0));
+  wedge = tracker.wedge(end, 3, wedge);
+  ASSERT_TRUE(wedge.valid);
+  EXPECT_TRUE(wedge.constrained);
+  EXPECT_NEAR(0, sinAngleToNormal(tracker.bisector(wedge),
+                                  Kernel::Vector_3(0, 0, 1)),
+              1e-9);
+
+  // No plane is within tolerance of points off the pivot line on both
+  // planes, y = 0 and z = 0.
+  tracker.addPoint(Kernel::Point_3(6, 0, 1));
+  EXPECT_FALSE(tracker.wedge(end, 4, wedge).valid);
+  EXPECT_FALSE(tracker.wedge(end, 4).valid);
+}
+
+TEST(Polyline_3SimplificationTest, circleFitLeastSquaresNoisyArc) {
+  // A unit semicircle in the plane z = 0, with exact end points, and inner
+  // points alternately off the circle by most of the tolerance. A circle
+  // through the end points and an inner point off one way is out of
+  // tolerance of the inner points off the other way.
+  const Kernel::FT tolerance = 0.01;
+  std::vector<Kernel::Point_3> points;
+  const int numSamples = 50;
+  for (int sample = 0; sample <= numSamples; ++sample) {
+    double angle = M_PI * (1 - double(sample) / numSamples);
+    double radius = 1;
+    if (sample != 0 && sample != numSamples) {
+      radius += (sample % 2 ? 0.8 : -0.8) * tolerance;
+    }
+    points.emplace_back(radius * std::cos(angle), radius * std::sin(angle), 0);
+  }
+  const Kernel::Plane_3 searchPlane(0, 0, 1, 0);
+
+  auto leastSquaresFit = circle_fit::fitCircleLeastSquares(
+      points.begin(), points.end() - 1, searchPlane, tolerance);
+  ASSERT_TRUE(std::get<0>(leastSquaresFit));
+  const CurvePrimitive_3& arc = std::get<1>(leastSquaresFit);
+  ASSERT_TRUE(arc.isArc());
+  EXPECT_EQ(points.front(), arc.start);
+  EXPECT_EQ(points.back(), arc.end);
+  EXPECT_NEAR(1, arc.radius(), 0.2 * tolerance);
+  EXPECT_NEAR(1, arc.pointAt(0.5).y(), 0.2 * tolerance);
+
+  // The least squares candidate is taken. Searched for off the plane of the
+  // arc, where that candidate is rejected, no three point one fits.
+  auto fit = circle_fit::findCircleFit(points.begin(), points.end() - 1,
+                                       searchPlane, tolerance);
+  ASSERT_TRUE(std::get<0>(fit));
+  EXPECT_EQ(arc.center, std::get<1>(fit).center);
+  EXPECT_FALSE(std::get<0>(circle_fit::findCircleFit(
+      points.begin(), points.end() - 1, Kernel::Plane_3(0, 1, 1, 0),
+      tolerance)));
+}
+
+TEST(Polyline_3SimplificationTest, circleFitFallsBackToThreePoints) {
+  // A unit semicircle in the plane z = 0, searched for in a plane through
+  // its chord that is tilted off it. The least squares candidate lies in the
+  // search plane, and is rejected; the three point search is not bound to it.
+  std::vector<Kernel::Point_3> points;
+  const int numSamples = 20;
+  for (int sample = 0; sample <= numSamples; ++sample) {
+    double angle = M_PI * (1 - double(sample) / numSamples);
+    points.emplace_back(std::cos(angle), std::sin(angle), 0);
+  }
+  const Kernel::Plane_3 tiltedPlane(0, 1, 1, 0);
+  const Kernel::FT tolerance = 0.01;
+
+  EXPECT_FALSE(std::get<0>(circle_fit::fitCircleLeastSquares(
+      points.begin(), points.end() - 1, tiltedPlane, tolerance)));
+  auto fit = circle_fit::findCircleFit(points.begin(), points.end() - 1,
+                                       tiltedPlane, tolerance);
+  ASSERT_TRUE(std::get<0>(fit));
+  const CurvePrimitive_3& arc = std::get<1>(fit);
+  ASSERT_TRUE(arc.isArc());
+  EXPECT_NEAR(1, arc.radius(), 1e-9);
+  EXPECT_NEAR(0, CGAL::squared_distance(arc.center, Kernel::Point_3(0, 0, 0)),
+              1e-18);
+  EXPECT_NEAR(M_PI, std::abs(arc.sweep), 1e-9);
+}
+
+TEST(Polyline_3SimplificationTest, circleFitPlanarArc) {
+  Polyline_3 arc = tiltedArc(200, 1.5 * M_PI);
+  Polyline_3Simplifier simplifier(0.01);
+  auto result = simplifier.simplifyToArcs(
+      arc, Polyline_3SimplificationStrategyNaiveBiarc());
+  ASSERT_EQ(1, std::get<0>(result));
+
+  const CurvePrimitive_3& fit = std::get<1>(result).begin()[0];
+  ASSERT_TRUE(fit.isArc());
+  EXPECT_NEAR(2, fit.radius(), 0.01);
+  EXPECT_NEAR(1.5 * M_PI, std::abs(fit.sweep), 0.01);
+  EXPECT_NEAR(0, std::sqrt(CGAL::cross_product(fit.normal,
+                                               Kernel::Vector_3(0, 1, 1))
+                               .squared_length() /
+                           2),
+              1e-6);
+}
+
+TEST(Polyline_3SimplificationTest, circleFitHelix) {
+  // Two turns of a helix, which arcs only approximate piecewise
+  Polyline_3 helix;
+  for (size_t point = 0; point < 400; ++point) {
+    double angle = point * M_PI / 100;
+    helix.addPoint(
+        Kernel::Point_3(std::cos(angle), std::sin(angle), 0.02 * angle));
+  }
+  const float tolerance = 0.01;
+  Polyline_3Simplifier simplifier(tolerance);
+  auto result =
+      simplifier.simplify(helix, Polyline_3SimplificationStrategyNaiveBiarc());
+  EXPECT_LT(std::get<0>(result), helix.size() / 10);
+
+  // Within tolerance of the input, but for the sampling of the arcs
+  Polyline_3Deviation deviation =
+      Polyline_3ErrorEvaluator(0.001).evaluate(helix, std::get<1>(result));
+  EXPECT_LE(deviation.maxOriginalToSimplified,
+            tolerance * (1 + Polyline_3Simplifier::ARC_SAMPLING_TOLERANCE));
+}
+
+// A noisy helix, long enough for the recursion to be split into many tasks
+std::vector<double> noisyHelix(size_t numPoints) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::vector<double> coords;
+  coords.reserve(3 * numPoints);
+  for (size_t point = 0; point < numPoints; ++point) {
+    double angle = point * 0.001;
+    coords.push_back(std::cos(angle) + noise(generator));
+    coords.push_back(std::sin(angle) + noise(generator));
+    coords.push_back(0.01 * angle + noise(generator));
+  }
+  return coords;
+}
+
+TEST(Polyline_3SimplificationTest, parallelDouglasPeuckerMatchesSequential) {
+  std::vector<double> coords = noisyHelix(200000);
+  for (double tolerance : {0.005, 0.02, 0.1}) {
+    std::vector<double> sequential;
+    psimpl::simplify_douglas_peucker<3>(coords.begin(), coords.end(),
+                                        tolerance,
+                                        std::back_inserter(sequential));
+    for (size_t grainSize : {16, 4096}) {
+      std::vector<double> parallel;
+      parallelDouglasPeucker<3>(coords.data(), coords.data() + coords.size(),
+                                tolerance, grainSize, parallel);
+      EXPECT_EQ(sequential, parallel);
+    }
+  }
+}
+
+TEST(Polyline_3SimplificationTest, parallelDouglasPeuckerStrategy) {
+  Polyline_3Simplifier simplifier(0.05);
+  Polyline_3 line;
+  line.addPoint(Kernel::Point_3(0, 0, 0));
+  line.addPoint(Kernel::Point_3(1, 0.01, 0));
+  line.addPoint(Kernel::Point_3(2, 0, 0));
+  line.addPoint(Kernel::Point_3(3, 1, 0));
+  line.addPoint(Kernel::Point_3(4, 0, 0));
+
+  auto result = simplifier.simplify(
+      line, Polyline_3SimplificationStrategyParallelDouglasPeucker());
+  // The near colinear point is dropped, the peak is kept.
+  EXPECT_EQ(4, std::get<0>(result));
+  EXPECT_EQ(Kernel::Point_3(3, 1, 0), *(std::get<1>(result).begin() + 2));
+}
+
+TEST(Polyline_3SimplificationTest, psimplAdaptersMatchFlatCoordinates) {
+  std::vector<double> coords = noisyHelix(20000);
+  std::vector<std::array<double, 3>> points(coords.size() / 3);
+  for (size_t point = 0; point < points.size(); ++point) {
+    points[point] = {coords[3 * point], coords[3 * point + 1],
+                     coords[3 * point + 2]};
+  }
+
+  using PointIterator = std::vector<std::array<double, 3>>::const_iterator;
+  using CoordinateIterator = FlatCoordinateIterator<PointIterator>;
+  std::vector<double> flat(CoordinateIterator::begin(points.cbegin()),
+                           CoordinateIterator::end(points.cbegin(),
+                                                   points.cend()));
+  EXPECT_EQ(coords, flat);
+
+  std::vector<double> expected;
+  psimpl::simplify_douglas_peucker<3>(coords.begin(), coords.end(), 0.02,
+                                      std::back_inserter(expected));
+  KeyIndexCollector<PointIterator> keyIndices(points.cbegin(), points.cend());
+  psimpl::simplify_douglas_peucker<3>(
+      CoordinateIterator::begin(points.cbegin()),
+      CoordinateIterator::end(points.cbegin(), points.cend()), 0.02,
+      keyIndices.outputIterator());
+  ASSERT_EQ(expected.size() / 3, keyIndices.indices().size());
+  for (size_t key = 0; key < keyIndices.indices().size(); ++key) {
+    const std::array<double, 3>& point = points[keyIndices.indices()[key]];
+    EXPECT_EQ(expected[3 * key], point[0]);
+    EXPECT_EQ(expected[3 * key + 1], point[1]);
+    EXPECT_EQ(expected[3 * key + 2], point[2]);
+  }
+}
+
+TEST(Polyline_3SimplificationTest, douglasPeuckerKeepsFullPrecision) {
+  // Features far below float resolution at this offset are kept, and the
+  // points come out bit for bit.
+  const double offset = 1e4;
+  Polyline_3Simplifier simplifier(1e-7);
+  Polyline_3 line;
+  line.addPoint(Kernel::Point_3(offset, 0, 0));
+  line.addPoint(Kernel::Point_3(offset + 1e-3, 1e-6, 0));
+  line.addPoint(Kernel::Point_3(offset + 2e-3, 0, 0));
+
+  auto result = simplifier.simplify(
+      line, Polyline_3SimplificationStrategyDouglasPeucker());
+  ASSERT_EQ(3, std::get<0>(result));
+  EXPECT_EQ(Kernel::Point_3(offset + 1e-3, 1e-6, 0),
+            *(std::get<1>(result).begin() + 1));
+}
+
+Polyline_3 noisyHelixPolyline(size_t numPoints) {
+  std::vector<double> coords = noisyHelix(numPoints);
+  Polyline_3 line;
+  for (size_t coord = 0; coord < coords.size(); coord += 3) {
+    line.addPoint(
+        Kernel::Point_3(coords[coord], coords[coord + 1], coords[coord + 2]));
+  }
+  return line;
+}
+
+// The largest distance of a point of line to simplified
+double maxDistance(const Polyline_3& line, const Polyline_3& simplified) {
+  double maxSquaredDistance = 0;
+  for (const Kernel::Point_3& point : line) {
+    maxSquaredDistance =
+        std::max<double>(maxSquaredDistance, simplified.squaredDistance(point));
+  }
+  return std::sqrt(maxSquaredDistance);
+}
+
+template <typename Strategy>
+void expectSimplifiedWithin(const Polyline_3& line, float tolerance,
+                            const Strategy& strategy) {
+  Polyline_3Simplifier simplifier(tolerance);
+  auto result = simplifier.simplify(line, strategy);
+  const Polyline_3& simplified = std::get<1>(result);
+  EXPECT_LT(std::get<0>(result), line.size() / 2);
+  EXPECT_EQ(*line.begin(), *simplified.begin());
+  EXPECT_EQ(*(line.end() - 1), *(simplified.end() - 1));
+  EXPECT_LE(maxDistance(line, simplified), tolerance * (1 + 1e-6));
+}
+
+TEST(Polyline_3SimplificationTest, linearTimeStrategies) {
+  Polyline_3 line = noisyHelixPolyline(5000);
+  expectSimplifiedWithin(line, 0.05,
+                         Polyline_3SimplificationStrategyRadialDistance());
+  expectSimplifiedWithin(line, 0.05, Polyline_3SimplificationStrategyLang());
+
+  // Reumann-Witkam and Opheim bound the distance to the lines through the
+  // kept points only.
+  Polyline_3Simplifier simplifier(0.05);
+  auto reumannWitkam = simplifier.simplify(
+      line, Polyline_3SimplificationStrategyReumannWitkam());
+  auto opheim =
+      simplifier.simplify(line, Polyline_3SimplificationStrategyOpheim());
+  EXPECT_LT(std::get<0>(reumannWitkam), line.size() / 2);
+  EXPECT_LT(std::get<0>(opheim), line.size() / 2);
+}
+
+TEST(Polyline_3SimplificationTest, cascadeKeepsTolerance) {
+  Polyline_3 line = noisyHelixPolyline(5000);
+  expectSimplifiedWithin(line, 0.05,
+                         Polyline_3SimplificationStrategyCascade<
+                             Polyline_3SimplificationStrategyDouglasPeucker>());
+  expectSimplifiedWithin(
+      line, 0.05,
+      Polyline_3SimplificationStrategyCascade<
+          Polyline_3SimplificationStrategyParallelDouglasPeucker>(
+          Polyline_3SimplificationStrategyParallelDouglasPeucker(16), 0.5));
+  expectSimplifiedWithin(line, 0.05,
+                         Polyline_3SimplificationStrategyCascade<
+                             Polyline_3SimplificationStrategyImaiIri>());
+  expectSimplifiedWithin(
+      line, 0.05,
+      Polyline_3SimplificationStrategyCascade<
+          Polyline_3SimplificationStrategyLang>(
+          Polyline_3SimplificationStrategyLang(16), 0.5));
+}
+
+TEST(Polyline_3SimplificationTest, parallelCascadeMatchesCascade) {
+  // Both run classic Douglas-Peucker on the prefiltered points, and neither
+  // psimpl's radial distance pass.
+  Polyline_3 line = noisyHelixPolyline(20000);
+  Polyline_3Simplifier simplifier(0.05);
+  for (size_t grainSize : {1, 16, 1000000}) {
+    auto expected = simplifier.simplify(
+        line, Polyline_3SimplificationStrategyCascade<
+                  Polyline_3SimplificationStrategyDouglasPeucker>());
+    auto parallel = simplifier.simplify(
+        line,
+        Polyline_3SimplificationStrategyCascade<
+            Polyline_3SimplificationStrategyParallelDouglasPeucker>(
+            Polyline_3SimplificationStrategyParallelDouglasPeucker(grainSize)));
+    EXPECT_EQ(std::get<0>(expected), std::get<0>(parallel));
+    EXPECT_TRUE(std::equal(std::get<1>(expected).begin(),
+                           std::get<1>(expected).end(),
+                           std::get<1>(parallel).begin(),
+                           std::get<1>(parallel).end()));
+  }
+}
+
+TEST(Polyline_3SimplificationTest, streamingSimplifier) {
+  Polyline_3 line = noisyHelixPolyline(5000);
+  Polyline_3 simplified;
+  const size_t maxWindowSize = 64;
+  Polyline_3StreamingSimplifier simplifier(
+      0.05,
+      [&simplified](const Kernel::Point_3& point) {
+        simplified.addPoint(point);
+      },
+      maxWindowSize);
+  for (const Kernel::Point_3& point : line) {
+    simplifier.addPoint(point);
+    EXPECT_LE(simplifier.windowSize(), maxWindowSize);
+  }
+  simplifier.finish();
+
+  EXPECT_LT(simplified.size(), line.size() / 2);
+  EXPECT_EQ(*line.begin(), *simplified.begin());
+  EXPECT_EQ(*(line.end() - 1), *(simplified.end() - 1));
+  EXPECT_LE(maxDistance(line, simplified), 0.05 * (1 + 1e-6));
+}
+
+TEST(Polyline_3SimplificationTest, streamingSimplifierEmitsCorners) {
+  std::vector<Kernel::Point_3> emitted;
+  Polyline_3StreamingSimplifier simplifier(
+      0.01, [&emitted](const Kernel::Point_3& point) {
+        emitted.push_back(point);
+      });
+  for (int x = 0; x <= 10; ++x) {
+    simplifier.addPoint(Kernel::Point_3(x, 0, 0));
+  }
+  EXPECT_EQ(1, emitted.size());
+  // The corner is final as soon as the first point past it arrives.
+  simplifier.addPoint(Kernel::Point_3(10, 1, 0));
+  ASSERT_EQ(2, emitted.size());
+  EXPECT_EQ(Kernel::Point_3(10, 0, 0), emitted.back());
+  simplifier.finish();
+  ASSERT_EQ(3, emitted.size());
+  EXPECT_EQ(Kernel::Point_3(10, 1, 0), emitted.back());
+}
+
+// Fewest vertices over all valid shortcuts, tested by brute force
+size_t optimalVertexCount(const Polyline_3& line, double tolerance) {
+  const size_t numPoints = line.size();
+  std::vector<size_t> hops(numPoints, numPoints);
+  hops[0] = 1;
+  for (size_t end = 1; end < numPoints; ++end) {
+    for (size_t start = 0; start < end; ++start) {
+      Kernel::Segment_3 segment(*(line.begin() + start), *(line.begin() + end));
+      bool valid = true;
+      for (size_t point = start + 1; point < end && valid; ++point) {
+        valid = CGAL::squared_distance(*(line.begin() + point), segment) <=
+                tolerance * tolerance;
+      }
+      if (valid) hops[end] = std::min(hops[end], hops[start] + 1);
+    }
+  }
+  return hops.back();
+}
+
+TEST(Polyline_3SimplificationTest, imaiIriIsOptimal) {
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<double> step(-0.5, 1);
+  for (int trial = 0; trial < 10; ++trial) {
+    Polyline_3 line;
+    Kernel::Point_3 point(0, 0, 0);
+    for (int index = 0; index < 80; ++index) {
+      point = Kernel::Point_3(point.x() + step(generator),
+                              point.y() + step(generator),
+                              point.z() + 0.2 * step(generator));
+      line.addPoint(point);
+    }
+
+    const float tolerance = 0.5;
+    Polyline_3Simplifier simplifier(tolerance);
+    auto result =
+        simplifier.simplify(line, Polyline_3SimplificationStrategyImaiIri());
+    EXPECT_EQ(optimalVertexCount(line, tolerance), std::get<0>(result));
+    EXPECT_LE(maxDistance(line, std::get<1>(result)), tolerance * (1 + 1e-6));
+  }
+}
+
+TEST(Polyline_3SimplificationTest, imaiIriNoWorseThanDouglasPeucker) {
+  Polyline_3 line = noisyHelixPolyline(4000);
+  Polyline_3Simplifier simplifier(0.05);
+  auto optimal =
+      simplifier.simplify(line, Polyline_3SimplificationStrategyImaiIri());
+  auto douglasPeucker = simplifier.simplify(
+      line, Polyline_3SimplificationStrategyDouglasPeucker());
+  EXPECT_LE(std::get<0>(optimal), std::get<0>(douglasPeucker));
+  EXPECT_EQ(*(line.end() - 1), *(std::get<1>(optimal).end() - 1));
+}
+
+TEST(Polyline_3SimplificationTest, errorEvaluatorOffsetLine) {
+  Polyline_3 original;
+  original.addPoint(Kernel::Point_3(0, 0, 0));
+  original.addPoint(Kernel::Point_3(10, 0, 0));
+  Polyline_3 offset;
+  offset.addPoint(Kernel::Point_3(0, 1, 0));
+  offset.addPoint(Kernel::Point_3(5, 1, 0));
+  offset.addPoint(Kernel::Point_3(10, 1, 0));
+
+  Polyline_3Deviation deviation =
+      Polyline_3ErrorEvaluator(0.1).evaluate(original, offset);
+  EXPECT_NEAR(1, deviation.hausdorff, 1e-12);
+  EXPECT_NEAR(1, deviation.meanDeviation, 1e-12);
+  EXPECT_EQ(101 + 101, deviation.numSamples);
+}
+
+TEST(Polyline_3SimplificationTest, errorEvaluatorIsTwoSided) {
+  // The spike of the simplified polyline is missed when measuring from the
+  // original only.
+  Polyline_3 original;
+  original.addPoint(Kernel::Point_3(0, 0, 0));
+  original.addPoint(Kernel::Point_3(10, 0, 0));
+  Polyline_3 spiked;
+  spiked.addPoint(Kernel::Point_3(0, 0, 0));
+  spiked.addPoint(Kernel::Point_3(5, 0, 0));
+  spiked.addPoint(Kernel::Point_3(5, 3, 0));
+  spiked.addPoint(Kernel::Point_3(5, 0, 0));
+  spiked.addPoint(Kernel::Point_3(10, 0, 0));
+
+  Polyline_3Deviation deviation =
+      Polyline_3ErrorEvaluator(0.01).evaluate(original, spiked);
+  EXPECT_NEAR(0, deviation.maxOriginalToSimplified, 1e-12);
+  EXPECT_NEAR(3, deviation.maxSimplifiedToOriginal, 1e-12);
+  EXPECT_NEAR(3, deviation.hausdorff, 1e-12);
+}
+
+TEST(Polyline_3SimplificationTest, errorEvaluatorMatchesBruteForce) {
+  Polyline_3 line = noisyHelixPolyline(5000);
+  const float tolerance = 0.05;
+  Polyline_3Simplifier simplifier(tolerance);
+  Polyline_3 simplified = std::get<1>(
+      simplifier.simplify(line, Polyline_3SimplificationStrategyLang()));
+
+  // With vertices only sampled, the evaluator matches the brute force
+  // distance over the vertices.
+  const double noSubsampling = 1e9;
+  Polyline_3Deviation atVertices =
+      Polyline_3ErrorEvaluator(noSubsampling).evaluate(line, simplified);
+  EXPECT_NEAR(maxDistance(line, simplified),
+              atVertices.maxOriginalToSimplified, 1e-12);
+  EXPECT_NEAR(maxDistance(simplified, line),
+              atVertices.maxSimplifiedToOriginal, 1e-12);
+
+  Polyline_3Deviation deviation =
+      Polyline_3ErrorEvaluator(0.001).evaluate(line, simplified);
+  EXPECT_GE(deviation.hausdorff, atVertices.hausdorff);
+  EXPECT_LE(deviation.hausdorff, tolerance * (1 + 1e-6));
+  EXPECT_LT(deviation.meanDeviation, deviation.hausdorff);
+}
+
+TEST(Polyline_3SimplificationTest, douglasPeuckerDeviation) {
+  // psimpl's radial distance pass ahead of Douglas-Peucker may let the
+  // deviation exceed the tolerance, though not twice the tolerance.
+  Polyline_3 line = noisyHelixPolyline(20000);
+  const float tolerance = 0.05;
+  Polyline_3Simplifier simplifier(tolerance);
+  Polyline_3 simplified = std::get<1>(simplifier.simplify(
+      line, Polyline_3SimplificationStrategyDouglasPeucker()));
+  Polyline_3Deviation deviation =
+      Polyline_3ErrorEvaluator(0.001).evaluate(line, simplified);
+  EXPECT_LE(deviation.hausdorff, 2 * tolerance);
+}
+
+TEST(Polyline_3SimplificationTest, douglasPeuckerRankingMatchesDouglasPeucker) {
+  // Points further apart than the tolerances, for psimpl's radial distance
+  // pass to keep them all.
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> noise(-0.02, 0.02);
+  Polyline_3 line;
+  for (size_t point = 0; point < 2000; ++point) {
+    double angle = point * 0.01;
+    line.addPoint(Kernel::Point_3(10 * std::cos(angle) + noise(generator),
+                                  10 * std::sin(angle) + noise(generator),
+                                  noise(generator)));
+  }
+
+  Polyline_3DouglasPeuckerRanking ranking(line);
+  for (float tolerance : {0.0015f, 0.005f, 0.01f, 0.025f}) {
+    Polyline_3Simplifier simplifier(tolerance);
+    auto expected = simplifier.simplify(
+        line, Polyline_3SimplificationStrategyDouglasPeucker());
+    auto ranked = ranking.simplify(tolerance);
+    EXPECT_EQ(std::get<0>(expected), std::get<0>(ranked));
+    EXPECT_TRUE(std::equal(std::get<1>(expected).begin(),
+                           std::get<1>(expected).end(),
+                           std::get<1>(ranked).begin(),
+                           std::get<1>(ranked).end()));
+  }
+}
+
+TEST(Polyline_3SimplificationTest, douglasPeuckerRankingKeepsTolerance) {
+  Polyline_3 line = noisyHelixPolyline(20000);
+  Polyline_3DouglasPeuckerRanking ranking(line);
+  EXPECT_TRUE(std::isinf(ranking.importances().front()));
+  EXPECT_TRUE(std::isinf(ranking.importances().back()));
+
+  // Results at decreasing tolerances are nested, and unlike psimpl's, within
+  // the tolerance of the original.
+  Polyline_3 coarser;
+  for (double tolerance : {0.05, 0.025, 0.01}) {
+    Polyline_3 simplified = std::get<1>(ranking.simplify(tolerance));
+    for (const Kernel::Point_3& point : coarser) {
+      EXPECT_NE(simplified.end(),
+                std::find(simplified.begin(), simplified.end(), point));
+    }
+    Polyline_3Deviation deviation =
+        Polyline_3ErrorEvaluator(0.001).evaluate(line, simplified);
+    EXPECT_LE(deviation.hausdorff, tolerance * (1 + 1e-6));
+    coarser = simplified;
+  }
+}
@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
 #include <polyline.h>
+#include <polyloop_3.h>
+#include <smoothing/adaptiveSmoothing.h>
+#include <smoothing/blockedLaplacianSmoothing.h>
+#include <smoothing/implicitSmoothing.h>
 #include <smoothing/polyline_3Smoother.h>
 
 using Polyline_3 = Polyline<Kernel::Point_3>;
@@ -38,3 +49,235 @@ TEST(Polyline_3SmoothingTest, laplacianSmoothingSimple) {
                                      *(smoothLine.begin() + 1)),
               0, 0.1);
 }
+
+TEST(Polyline_3SmoothingTest, laplacianSmoothingMatchesLaplaceMatrix) {
+  // Reference: iterations as products with the dense Laplace matrix, which
+  // round differently from the stencil, and are thus only matched closely.
+  const size_t numPoints = 200;
+  const float stepSize = 0.05;
+  const size_t numIterations = 100;
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<float> noise(-0.1, 0.1);
+  Polyline_3 line;
+  for (size_t point = 0; point < numPoints; ++point) {
+    line.addPoint(Kernel::Point_3(0.1 * point, noise(generator),
+                                  noise(generator)));
+  }
+
+  Eigen::MatrixXf laplacian = Eigen::MatrixXf::Zero(numPoints, numPoints);
+  for (size_t i = 1; i + 1 < numPoints; ++i) {
+    laplacian(i, i) = -2;
+    laplacian(i, i - 1) = 1;
+    laplacian(i, i + 1) = 1;
+  }
+  Eigen::MatrixXf expected(numPoints, 3);
+  size_t row = 0;
+  for (const Kernel::Point_3& point : line) {
+    expected.row(row++) << point.x(), point.y(), point.z();
+  }
+  for (size_t i = 0; i < numIterations; ++i) {
+    expected = expected + stepSize * laplacian * expected;
+    expected = expected - 0.5f * stepSize * laplacian * expected;
+  }
+
+  Polyline_3Smoother smoother;
+  Polyline_3 smoothLine = smoother.smooth(
+      line, Polyline_3SmoothingStrategyLaplacian(stepSize, numIterations));
+  ASSERT_EQ(numPoints, smoothLine.size());
+  row = 0;
+  for (const Kernel::Point_3& point : smoothLine) {
+    EXPECT_NEAR(expected(row, 0), point.x(), 1e-5);
+    EXPECT_NEAR(expected(row, 1), point.y(), 1e-5);
+    EXPECT_NEAR(expected(row, 2), point.z(), 1e-5);
+    ++row;
+  }
+}
+
+TEST(Polyline_3SmoothingTest, laplacianSmoothingLongPolyline) {
+  // Far beyond what a dense Laplace matrix fits in memory for
+  std::vector<float> coords(3 * 1000000);
+  for (size_t coord = 0; coord < coords.size(); ++coord) {
+    coords[coord] = (coord / 3) % 2 ? 1 : -1;
+  }
+  laplacianSmoothing<3>(coords.data(), coords.size() / 3, 0.05f, 100);
+  // The zigzag is flattened away from the ends.
+  EXPECT_NEAR(0, coords[3 * 500000], 0.01);
+  EXPECT_EQ(-1, coords.front());
+  EXPECT_EQ(1, coords.back());
+}
+
+// Largest entry of (I - lambda L) x - x0 over the points where the system
+// applies, with the neighbours of the ends wrapping around if closed.
+double implicitResidual(const std::vector<double>& x,
+                        const std::vector<double>& x0, double lambda,
+                        bool closed) {
+  const size_t numPoints = x.size() / 3;
+  double residual = 0;
+  for (size_t point = closed ? 0 : 1;
+       point < (closed ? numPoints : numPoints - 1); ++point) {
+    size_t previous = (point + numPoints - 1) % numPoints;
+    size_t next = (point + 1) % numPoints;
+    for (size_t d = 0; d < 3; ++d) {
+      double laplacian =
+          x[3 * previous + d] - 2 * x[3 * point + d] + x[3 * next + d];
+      residual = std::max(
+          residual, std::abs(x[3 * point + d] - lambda * laplacian -
+                             x0[3 * point + d]));
+    }
+  }
+  return residual;
+}
+
+TEST(Polyline_3SmoothingTest, implicitLaplaceStepSolves) {
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<double> coordinate(-1, 1);
+  std::vector<double> x0(3 * 1000);
+  for (double& coord : x0) coord = coordinate(generator);
+
+  for (double lambda : {0.1, 2.5, 1000.0}) {
+    std::vector<double> open = x0;
+    implicitLaplaceStep<3>(open.data(), open.size() / 3, lambda);
+    EXPECT_LT(implicitResidual(open, x0, lambda, false), 1e-9);
+    // Ends are kept fixed.
+    EXPECT_TRUE(std::equal(x0.begin(), x0.begin() + 3, open.begin()));
+    EXPECT_TRUE(std::equal(x0.end() - 3, x0.end(), open.end() - 3));
+
+    std::vector<double> closed = x0;
+    implicitLaplaceStepCyclic<3>(closed.data(), closed.size() / 3, lambda);
+    EXPECT_LT(implicitResidual(closed, x0, lambda, true), 1e-9);
+  }
+}
+
+TEST(Polyline_3SmoothingTest, implicitSmoothingMatchesLaplacianStrength) {
+  // A sine of a period of 50 points is damped about as much by either
+  // strategy, for the same step size and number of iterations.
+  Polyline_3 line;
+  for (size_t point = 0; point <= 500; ++point) {
+    line.addPoint(
+        Kernel::Point_3(0.01 * point, std::sin(2 * M_PI * point / 50), 0));
+  }
+  Polyline_3Smoother smoother;
+  Polyline_3 laplacian =
+      smoother.smooth(line, Polyline_3SmoothingStrategyLaplacian(0.05, 100));
+  Polyline_3 implicit =
+      smoother.smooth(line, Polyline_3SmoothingStrategyImplicit(0.05, 100));
+  const Kernel::Point_3& laplacianPeak = *(laplacian.begin() + 262);
+  const Kernel::Point_3& implicitPeak = *(implicit.begin() + 262);
+  EXPECT_LT(laplacianPeak.y(), 0.97);
+  EXPECT_NEAR(laplacianPeak.y(), implicitPeak.y(), 0.005);
+
+  // As a loop, the first point is pulled towards the last, as they are
+  // neighbours, and away from the ends the loop smooths as the polyline.
+  Polyloop_3 loop;
+  for (size_t point = 0; point < 500; ++point) {
+    loop.addPoint(
+        Kernel::Point_3(0.01 * point, std::sin(2 * M_PI * point / 50), 0));
+  }
+  Polyloop_3 smoothLoop =
+      smoother.smooth(loop, Polyline_3SmoothingStrategyImplicit(0.05, 100));
+  EXPECT_NEAR(implicitPeak.y(), (smoothLoop.begin() + 262)->y(), 1e-6);
+  EXPECT_GT(smoothLoop.begin()->x(), 0.1);
+}
+
+TEST(Polyline_3SmoothingTest, blockedLaplacianSmoothingMatchesIterations) {
+  std::mt19937 generator(9);
+  std::uniform_real_distribution<float> coordinate(-1, 1);
+  const size_t numPoints = 20000;
+  std::vector<float> flat(3 * numPoints);
+  for (float& coord : flat) coord = coordinate(generator);
+  std::vector<float> expected = flat;
+  laplacianSmoothing<3>(expected.data(), numPoints, 0.05f, 100);
+
+  // Tiles and blocks that do and do not divide the points and iterations
+  for (size_t tileSize : {64, 1000, 4096, 100000}) {
+    for (size_t iterationsPerTile : {1, 7, 16}) {
+      std::vector<float> soa(3 * numPoints);
+      float* const coords[3] = {soa.data(), soa.data() + numPoints,
+                                soa.data() + 2 * numPoints};
+      for (size_t point = 0; point < numPoints; ++point) {
+        for (size_t d = 0; d < 3; ++d) coords[d][point] = flat[3 * point + d];
+      }
+      blockedLaplacianSmoothing<3>(coords, numPoints, 0.05f, 100, tileSize,
+                                   iterationsPerTile);
+      size_t numMismatches = 0;
+      for (size_t point = 0; point < numPoints; ++point) {
+        for (size_t d = 0; d < 3; ++d) {
+          numMismatches += coords[d][point] != expected[3 * point + d];
+        }
+      }
+      EXPECT_EQ(0, numMismatches) << "tile size " << tileSize
+                                  << ", iterations per tile "
+                                  << iterationsPerTile;
+    }
+  }
+}
+
+// A planar arc of a circle of radius 1, with noise on a few points about
+// noisyPoint.
+Polyline_3 arcWithNoise(size_t numPoints, size_t noisyPoint) {
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<double> noise(-0.002, 0.002);
+  Polyline_3 arc;
+  for (size_t point = 0; point < numPoints; ++point) {
+    double angle = M_PI * point / (numPoints - 1);
+    double offset =
+        point + 3 > noisyPoint && point < noisyPoint + 3 ? noise(generator) : 0;
+    arc.addPoint(Kernel::Point_3((1 + offset) * std::cos(angle),
+                                 (1 + offset) * std::sin(angle), 0));
+  }
+  return arc;
+}
+
+TEST(Polyline_3SmoothingTest, curvatureAdaptiveSmoothingIsLocal) {
+  const size_t numPoints = 1000;
+  Polyline_3 arc = arcWithNoise(numPoints, 500);
+  Polyline_3Smoother smoother;
+  Polyline_3 smoothArc = smoother.smooth(
+      arc, Polyline_3SmoothingStrategyCurvatureAdaptive(0.05, 100, 5));
+
+  // Points away from the noise are returned as they are.
+  size_t numMoved = 0;
+  auto smoothPoint = smoothArc.begin();
+  for (const Kernel::Point_3& point : arc) {
+    numMoved += !(point == *smoothPoint++);
+  }
+  EXPECT_GT(numMoved, 0);
+  EXPECT_LT(numMoved, numPoints / 20);
+
+  // The noisy points are brought back near the circle.
+  for (size_t point = 498; point < 503; ++point) {
+    const Kernel::Point_3& smoothed = *(smoothArc.begin() + point);
+    EXPECT_NEAR(1, std::hypot(smoothed.x(), smoothed.y()), 0.001);
+  }
+}
+
+TEST(Polyline_3SmoothingTest, curvatureAdaptiveSmoothingRestoresArea) {
+  // A noisy bump, all of which is smoothed as a single window. The window
+  // area is preserved, where plain smoothing shrinks the bump.
+  const size_t numPoints = 41;
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::vector<double> coords;
+  for (size_t point = 0; point < numPoints; ++point) {
+    double t = point / double(numPoints - 1);
+    double height = point == 0 || point + 1 == numPoints
+                        ? 0
+                        : std::sin(M_PI * t) + noise(generator);
+    coords.insert(coords.end(), {t, height, 0});
+  }
+  const double area = adaptive_smoothing::windowArea(coords.data(), 0,
+                                                     numPoints - 1)[2];
+
+  std::vector<double> plain = coords;
+  laplacianSmoothing<3>(plain.data(), numPoints, 0.25, 100);
+  const double plainArea =
+      adaptive_smoothing::windowArea(plain.data(), 0, numPoints - 1)[2];
+  EXPECT_LT(plainArea / area, 0.95);
+
+  size_t numSmoothed = curvatureAdaptiveSmoothing(
+      coords.data(), numPoints, 0.25, 100, 0.0, numPoints, 4);
+  EXPECT_EQ(numPoints - 2, numSmoothed);
+  const double smoothedArea =
+      adaptive_smoothing::windowArea(coords.data(), 0, numPoints - 1)[2];
+  EXPECT_NEAR(1, smoothedArea / area, 0.01);
+}
@@ -80,3 +80,62 @@ TEST_F(UniformPlanarGridTest, iterationUnitGrid) {
   }
   EXPECT_EQ(count, 1);
 }
+
+TEST_F(UniformPlanarGridTest, indexedAccess) {
+  for (size_t v = 0; v < GRID_SIZE; ++v) {
+    for (size_t u = 0; u < GRID_SIZE; ++u) {
+      EXPECT_EQ(grid1->point(u, v), expected[v * GRID_SIZE + u]);
+    }
+  }
+}
+
+TEST_F(UniformPlanarGridTest, randomAccessIteration) {
+  EXPECT_EQ(grid1->end() - grid1->begin(), grid1->size());
+  EXPECT_EQ(*(grid1->begin() + 3), expected[3]);
+  EXPECT_EQ(Kernel::Point_3(grid1->begin()[2]), expected[2]);
+  EXPECT_EQ(*(grid1->end() - 1), expected.back());
+  EXPECT_EQ(*grid1->rowBegin(1), expected[2]);
+  EXPECT_TRUE(grid1->begin() < grid1->end());
+}
+
+TEST_F(UniformPlanarGridTest, rowRanges) {
+  UniformPlanarGrid grid(planePoints[0], planePoints[1], planePoints[2], 5, 7,
+                         GRID_EXTENT, GRID_EXTENT);
+  std::vector<UniformPlanarGrid::Tile> ranges = grid.rowRanges(3);
+  ASSERT_EQ(ranges.size(), 3);
+  size_t nextRow = 0;
+  for (const auto& range : ranges) {
+    EXPECT_EQ(range.uBegin, 0);
+    EXPECT_EQ(range.uEnd, 5);
+    EXPECT_EQ(range.vBegin, nextRow);
+    nextRow = range.vEnd;
+  }
+  EXPECT_EQ(nextRow, 7);
+
+  // Never more ranges than rows
+  EXPECT_EQ(grid.rowRanges(100).size(), 7);
+}
+
+TEST_F(UniformPlanarGridTest, tilesAndBatchCoordinates) {
+  UniformPlanarGrid grid(planePoints[0], planePoints[1], planePoints[2], 5, 7,
+                         GRID_EXTENT, GRID_EXTENT);
+  std::vector<UniformPlanarGrid::Tile> tiles = grid.tiles(2, 3);
+  EXPECT_EQ(tiles.size(), 3 * 3);
+
+  size_t numSamples = 0;
+  for (const auto& tile : tiles) {
+    numSamples += tile.size();
+    std::vector<FieldType> xs(tile.size()), ys(tile.size()), zs(tile.size());
+    grid.fillTileCoordinates(tile, xs.data(), ys.data(), zs.data());
+    size_t index = 0;
+    for (size_t v = tile.vBegin; v < tile.vEnd; ++v) {
+      for (size_t u = tile.uBegin; u < tile.uEnd; ++u, ++index) {
+        Kernel::Point_3 point = grid.point(u, v);
+        EXPECT_NEAR(xs[index], point.x(), 1e-12);
+        EXPECT_NEAR(ys[index], point.y(), 1e-12);
+        EXPECT_NEAR(zs[index], point.z(), 1e-12);
+      }
+    }
+  }
+  EXPECT_EQ(numSamples, grid.size());
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "containerAlgorithms.h"
 #include "uniformVoxelGrid.h"
@@ -37,10 +39,70 @@ TEST_F(UniformVoxelGridTest, size) {
 
 TEST_F(UniformVoxelGridTest, voxelBounds) {
   EXPECT_EQ(-GRID_EXTENT, grid->voxelBoundsForLocation(*grid->begin())[0].x());
-  // TODO msati3: What is the ordering of generated grid points? Figuring out
-  // this will enable writing additional tests for the voxel grid
-  /*EXPECT_EQ(-GRID_EXTENT + (2 * GRID_EXTENT / GRID_SIZE),
-            grid->voxelBoundsForLocation(*(++grid->begin()))[0].x());*/
+  EXPECT_EQ(-GRID_EXTENT + (2 * GRID_EXTENT / GRID_SIZE),
+            grid->voxelBoundsForLocation(*(++grid->begin()))[0].x());
+}
+
+TEST_F(UniformVoxelGridTest, voxelBoundsRoundDown) {
+  // Locations on the negative side of the origin must round towards -extent,
+  // and voxels are closed below, open above.
+  Kernel::Iso_cuboid_3 bounds =
+      grid->voxelBoundsForLocation(Kernel::Point_3(-0.5, -2, 0));
+  EXPECT_EQ(-2, bounds.xmin());
+  EXPECT_EQ(0, bounds.xmax());
+  EXPECT_EQ(-2, bounds.ymin());
+  EXPECT_EQ(0, bounds.ymax());
+  EXPECT_EQ(0, bounds.zmin());
+  EXPECT_EQ(2, bounds.zmax());
+}
+
+TEST_F(UniformVoxelGridTest, voxelBoundsOutside) {
+  Kernel::Iso_cuboid_3 bounds = grid->voxelBoundsForLocation(
+      Kernel::Point_3(GRID_EXTENT, 0, 0));
+  EXPECT_EQ(bounds.xmin(), bounds.xmax());
+  bounds = grid->voxelBoundsForLocation(
+      Kernel::Point_3(0, -GRID_EXTENT - 1, 0));
+  EXPECT_EQ(bounds.ymin(), bounds.ymax());
+}
+
+TEST_F(UniformVoxelGridTest, randomAccess) {
+  const FieldType increment = 2 * GRID_EXTENT / GRID_SIZE;
+  size_t linearIndex = grid->linearIndex(Index_3(3, 4, 5));
+  Kernel::Point_3 center = grid->begin()[linearIndex];
+  EXPECT_DOUBLE_EQ(-GRID_EXTENT + 3.5 * increment, center.x());
+  EXPECT_DOUBLE_EQ(-GRID_EXTENT + 4.5 * increment, center.y());
+  EXPECT_DOUBLE_EQ(-GRID_EXTENT + 5.5 * increment, center.z());
+  EXPECT_EQ(Index_3(3, 4, 5), grid->voxelIndex(linearIndex));
+  EXPECT_EQ(static_cast<std::ptrdiff_t>(grid->size()),
+            grid->end() - grid->begin());
+
+  // Every voxel center lies within its own voxel
+  for (auto iter = grid->begin(); iter != grid->end(); ++iter) {
+    Kernel::Iso_cuboid_3 bounds = grid->voxelBoundsForLocation(*iter);
+    EXPECT_DOUBLE_EQ(bounds.xmin() + increment / 2, iter->x());
+    EXPECT_DOUBLE_EQ(bounds.ymin() + increment / 2, iter->y());
+    EXPECT_DOUBLE_EQ(bounds.zmin() + increment / 2, iter->z());
+  }
+}
+
+TEST_F(UniformVoxelGridTest, splitRange) {
+  std::vector<UniformVoxelGrid::Range> ranges = grid->splitRange(7);
+  ASSERT_EQ(7, ranges.size());
+  EXPECT_EQ(grid->begin(), ranges.front().first);
+  EXPECT_EQ(grid->end(), ranges.back().second);
+  for (size_t range = 1; range < ranges.size(); ++range) {
+    EXPECT_EQ(ranges[range - 1].second, ranges[range].first);
+  }
+}
+
+TEST(UniformVoxelGridLargeTest, implicitStorage) {
+  // Large grids need no per voxel storage
+  UniformVoxelGrid grid(GRID_EXTENT, 512);
+  EXPECT_EQ(512 * 512 * 512, grid.size());
+  Kernel::Point_3 last = *(grid.end() - 1);
+  const FieldType halfIncrement = GRID_EXTENT / 512;
+  EXPECT_DOUBLE_EQ(GRID_EXTENT - halfIncrement, last.x());
+  EXPECT_DOUBLE_EQ(GRID_EXTENT - halfIncrement, last.z());
 }
 
 TEST_F(UniformVoxelGridGeometryProviderTest, pointProviderIteration) {
@@ -55,9 +117,11 @@ TEST_F(UniformVoxelGridGeometryProviderTest, pointProviderIteration) {
 TEST_F(UniformVoxelGridGeometryProviderTest, pointProviderContent) {
   VoxelGridPointProvider pointProvider(*grid);
   auto vertexIter = pointProvider.begin();
-  EXPECT_EQ(vertexIter->x(), -GRID_EXTENT);
-  EXPECT_EQ(vertexIter->y(), -GRID_EXTENT);
-  EXPECT_EQ(vertexIter->z(), -GRID_EXTENT);
+  // Points are placed at the voxel centers
+  const FieldType halfIncrement = GRID_EXTENT / GRID_SIZE;
+  EXPECT_EQ(vertexIter->x(), -GRID_EXTENT + halfIncrement);
+  EXPECT_EQ(vertexIter->y(), -GRID_EXTENT + halfIncrement);
+  EXPECT_EQ(vertexIter->z(), -GRID_EXTENT + halfIncrement);
 }
 
 TEST_F(UniformVoxelGridGeometryProviderTest, cubeProviderIteration) {
@@ -78,3 +142,93 @@ TEST_F(UniformVoxelGridGeometryProviderTest, cubeProviderContent) {
   EXPECT_EQ(vertexIter->y(), -GRID_EXTENT);
   EXPECT_EQ(vertexIter->z(), -GRID_EXTENT);
 }
+
+TEST_F(UniformVoxelGridTest, voxelIndexForLocation) {
+  Index_3 index;
+  ASSERT_TRUE(grid->voxelIndexForLocation(Kernel::Point_3(-0.5, 0, 9.9),
+                                          index));
+  EXPECT_EQ(Index_3(4, 5, 9), index);
+  EXPECT_FALSE(grid->voxelIndexForLocation(
+      Kernel::Point_3(0, GRID_EXTENT, 0), index));
+}
+
+TEST_F(UniformVoxelGridTest, rayTraversal) {
+  // An axis aligned ray starting outside the grid crosses a whole row
+  std::vector<Index_3> visited;
+  grid->traverseRay(Kernel::Ray_3(Kernel::Point_3(-20, 1, 1),
+                                  Kernel::Vector_3(1, 0, 0)),
+                    [&visited](const Index_3& index, FieldType, FieldType) {
+                      visited.push_back(index);
+                      return true;
+                    });
+  ASSERT_EQ(GRID_SIZE, visited.size());
+  for (size_t i = 0; i < visited.size(); ++i) {
+    EXPECT_EQ(Index_3(i, 5, 5), visited[i]);
+  }
+
+  // A diagonal ray visits face adjacent voxels, with contiguous parameters
+  visited.clear();
+  FieldType lastExit = 0;
+  grid->traverseRay(
+      Kernel::Point_3(-9, -9.5, -9.75), Kernel::Vector_3(1, 1, 1),
+      [&](const Index_3& index, FieldType tEnter, FieldType tExit) {
+        if (!visited.empty()) {
+          EXPECT_DOUBLE_EQ(lastExit, tEnter);
+          const Index_3& last = visited.back();
+          long steps =
+              std::abs(long(std::get<0>(index)) - long(std::get<0>(last))) +
+              std::abs(long(std::get<1>(index)) - long(std::get<1>(last))) +
+              std::abs(long(std::get<2>(index)) - long(std::get<2>(last)));
+          EXPECT_EQ(1, steps);
+        }
+        EXPECT_LE(tEnter, tExit);
+        lastExit = tExit;
+        visited.push_back(index);
+        return true;
+      });
+  EXPECT_EQ(Index_3(0, 0, 0), visited.front());
+  EXPECT_EQ(Index_3(GRID_SIZE - 1, GRID_SIZE - 1, GRID_SIZE - 1),
+            visited.back());
+
+  // Rays missing the grid visit nothing, and visitors can stop traversal
+  visited.clear();
+  auto visitOne = [&visited](const Index_3& index, FieldType, FieldType) {
+    visited.push_back(index);
+    return false;
+  };
+  grid->traverseRay(Kernel::Point_3(-20, 11, 0), Kernel::Vector_3(1, 0, 0),
+                    visitOne);
+  EXPECT_TRUE(visited.empty());
+  grid->traverseRay(Kernel::Point_3(9, 9, 9), Kernel::Vector_3(-1, 0, 0),
+                    visitOne);
+  ASSERT_EQ(1, visited.size());
+  EXPECT_EQ(Index_3(9, 9, 9), visited.front());
+}
+
+TEST_F(UniformVoxelGridTest, rangeQueries) {
+  size_t numVoxels = 0;
+  grid->voxelsInBox(Kernel::Iso_cuboid_3(-1, -1, -1, 1, 3, 100),
+                    [&numVoxels](const Index_3&) { ++numVoxels; });
+  // 2 voxels along x, 3 along y, and 6 along z, after clamping to the grid
+  EXPECT_EQ(2 * 3 * 6, numVoxels);
+
+  numVoxels = 0;
+  grid->voxelsInBox(Kernel::Iso_cuboid_3(20, 0, 0, 30, 1, 1),
+                    [&numVoxels](const Index_3&) { ++numVoxels; });
+  EXPECT_EQ(0, numVoxels);
+
+  // The ball touches the 8 voxels around the origin, but not the ones beyond
+  std::vector<Index_3> visited;
+  grid->voxelsInBall(Kernel::Point_3(0, 0, 0), 1.5,
+                     [&visited](const Index_3& index) {
+                       visited.push_back(index);
+                     });
+  EXPECT_EQ(8, visited.size());
+  visited.clear();
+  grid->voxelsInBall(Kernel::Point_3(0, 0, 0), 2.5,
+                     [&visited](const Index_3& index) {
+                       visited.push_back(index);
+                     });
+  // Additionally, the 24 voxels sharing a face with the central cube
+  EXPECT_EQ(8 + 24, visited.size());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "voxelGridPicker.h"
+
+constexpr size_t GRID_SIZE = 6;
+constexpr float GRID_EXTENT = 3.0;
+
+class VoxelGridPickerTest : public ::testing::Test {
+ protected:
+  VoxelGridPickerTest()
+      : grid(GRID_EXTENT, GRID_SIZE),
+        occupancy(grid, 0),
+        picker(grid, occupancy) {}
+
+  UniformVoxelGrid grid;
+  VoxelGridPicker::Occupancy occupancy;
+  VoxelGridPicker picker;
+};
+
+TEST_F(VoxelGridPickerTest, emptyGrid) {
+  Kernel::Ray_3 ray(Kernel::Point_3(-10, 0.5, 0.5), Kernel::Vector_3(1, 0, 0));
+  EXPECT_TRUE(std::isinf(picker.queryDistance(ray)));
+  EXPECT_FALSE(picker.hasHit());
+  EXPECT_FALSE(picker.select());
+  Index_3 index;
+  EXPECT_FALSE(picker.selectedVoxel(index));
+}
+
+TEST_F(VoxelGridPickerTest, firstOccupiedVoxel) {
+  // Voxels are a unit wide, and the row at j = k = 3 spans y, z in [0, 1].
+  occupancy.at(2, 3, 3) = 1;
+  occupancy.at(4, 3, 3) = 1;
+
+  // Distances are along the ray, whatever the length of its direction.
+  Kernel::Ray_3 ray(Kernel::Point_3(-10, 0.5, 0.5), Kernel::Vector_3(2, 0, 0));
+  EXPECT_NEAR(9, picker.queryDistance(ray), 1e-9);
+  EXPECT_TRUE(picker.hasHit());
+  EXPECT_TRUE(picker.select());
+  Index_3 index;
+  ASSERT_TRUE(picker.selectedVoxel(index));
+  EXPECT_EQ(Index_3(2, 3, 3), index);
+
+  Kernel::Ray_3 reverse(Kernel::Point_3(10, 0.5, 0.5),
+                        Kernel::Vector_3(-1, 0, 0));
+  EXPECT_NEAR(8, picker.queryDistance(reverse), 1e-9);
+  EXPECT_TRUE(picker.select());
+  ASSERT_TRUE(picker.selectedVoxel(index));
+  EXPECT_EQ(Index_3(4, 3, 3), index);
+}
+
+TEST_F(VoxelGridPickerTest, missKeepsSelectionUntilSelected) {
+  occupancy.at(2, 3, 3) = 1;
+  picker.queryDistance(
+      Kernel::Ray_3(Kernel::Point_3(-10, 0.5, 0.5), Kernel::Vector_3(1, 0, 0)));
+  picker.select();
+
+  // A ray through empty voxels only
+  Kernel::Ray_3 miss(Kernel::Point_3(-10, -0.5, 0.5),
+                     Kernel::Vector_3(1, 0, 0));
+  EXPECT_TRUE(std::isinf(picker.queryDistance(miss)));
+  EXPECT_FALSE(picker.hasHit());
+  Index_3 index;
+  ASSERT_TRUE(picker.selectedVoxel(index));
+  EXPECT_EQ(Index_3(2, 3, 3), index);
+
+  EXPECT_FALSE(picker.select());
+  EXPECT_FALSE(picker.selectedVoxel(index));
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "voxelMesher.h"
+
+constexpr size_t GRID_SIZE = 6;
+constexpr float GRID_EXTENT = 3.0;
+
+class VoxelMesherTest : public ::testing::Test {
+ protected:
+  VoxelMesherTest()
+      : grid(GRID_EXTENT, GRID_SIZE), occupancy(grid, 0), mesher(grid) {}
+
+  // The signed volume enclosed by the mesh, which matches the occupied volume
+  // only if the surface is closed and consistently oriented outwards.
+  static double enclosedVolume(const IndexedTriangleMesh& mesh) {
+    const std::vector<float>& positions = mesh.positions();
+    const std::vector<IndexedTriangleMesh::IndexType>& indices =
+        mesh.indices();
+    double volume = 0;
+    for (size_t triangle = 0; triangle < indices.size(); triangle += 3) {
+      const float* a = &positions[3 * indices[triangle]];
+      const float* b = &positions[3 * indices[triangle + 1]];
+      const float* c = &positions[3 * indices[triangle + 2]];
+      volume += a[0] * (b[1] * c[2] - b[2] * c[1]) -
+                a[1] * (b[0] * c[2] - b[2] * c[0]) +
+                a[2] * (b[0] * c[1] - b[1] * c[0]);
+    }
+    return volume / 6;
+  }
+
+  UniformVoxelGrid grid;
+  VoxelMesher::Occupancy occupancy;
+  VoxelMesher mesher;
+  IndexedTriangleMesh mesh;
+};
+
+TEST_F(VoxelMesherTest, empty) {
+  mesher.build(occupancy, mesh);
+  EXPECT_TRUE(mesh.empty());
+}
+
+TEST_F(VoxelMesherTest, singleVoxel) {
+  occupancy.at(2, 3, 4) = 1;
+  mesher.build(occupancy, mesh);
+  EXPECT_EQ(8, mesh.numVertices());
+  EXPECT_EQ(12, mesh.numTriangles());
+  EXPECT_NEAR(1.0, enclosedVolume(mesh), 1e-5);
+}
+
+TEST_F(VoxelMesherTest, hiddenFacesAreSkipped) {
+  occupancy.at(2, 3, 4) = 1;
+  occupancy.at(3, 3, 4) = 1;
+  mesher.build(occupancy, mesh);
+  // Ten exposed faces, and no vertices duplicated between them.
+  EXPECT_EQ(12, mesh.numVertices());
+  EXPECT_EQ(20, mesh.numTriangles());
+  EXPECT_NEAR(2.0, enclosedVolume(mesh), 1e-5);
+}
+
+TEST_F(VoxelMesherTest, mergedFaces) {
+  // A block spanning the whole grid along i, and touching its boundary
+  for (size_t k = 0; k < 3; ++k) {
+    for (size_t j = 1; j < 3; ++j) {
+      for (size_t i = 0; i < GRID_SIZE; ++i) {
+        occupancy.at(i, j, k) = 1;
+      }
+    }
+  }
+  mesher.build(occupancy, mesh, true /*mergeFaces*/);
+  EXPECT_EQ(8, mesh.numVertices());
+  EXPECT_EQ(12, mesh.numTriangles());
+  EXPECT_NEAR(GRID_SIZE * 2 * 3, enclosedVolume(mesh), 1e-4);
+
+  IndexedTriangleMesh unmerged;
+  mesher.build(occupancy, unmerged);
+  EXPECT_LT(mesh.numTriangles(), unmerged.numTriangles());
+  EXPECT_NEAR(GRID_SIZE * 2 * 3, enclosedVolume(unmerged), 1e-4);
+}
+
+TEST_F(VoxelMesherTest, mergedFacesWithHoles) {
+  // A slab with a hole through it
+  for (size_t j = 0; j < GRID_SIZE; ++j) {
+    for (size_t i = 0; i < GRID_SIZE; ++i) {
+      occupancy.at(i, j, 2) = (i == 3 && j == 2) ? 0 : 1;
+    }
+  }
+  mesher.build(occupancy, mesh, true /*mergeFaces*/);
+  EXPECT_NEAR(GRID_SIZE * GRID_SIZE - 1, enclosedVolume(mesh), 1e-4);
+}